@@ -0,0 +1,335 @@
+// loggerCpp_bench: enqueue latency and end-to-end throughput of the logging engine.
+//
+// Every scenario pairs a mode (sync/async) with a sink and runs with 1..64 producer threads; in
+// sync mode those contend for the router's lock. Results are printed as one JSON document so
+// runs can be compared between releases.
+
+#include "loggerCpp/loggingEngine.hpp"
+#include "loggerCpp/binaryLogSink.hpp"
+#include "loggerCpp/consoleLogSink.hpp"
+#include "loggerCpp/dataBaseLogSink.hpp"
+#include "loggerCpp/fileLogSink.hpp"
+#include "loggerCpp/jsonLogSink.hpp"
+#include "loggerCpp/networkLogSink.hpp"
+#ifdef __unix__
+#include "loggerCpp/mmapFileLogSink.hpp"
+#include "loggerCpp/sysLogSink.hpp"
+#endif
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <latch>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef __unix__
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Counts events and discards them: measures the engine without any I/O
+    class NullLogSink final : public LogSink {
+    public:
+        void write(const utils::LogEvent&) override { ++count; }
+        void writeBatch(std::span<const utils::LogEvent> events) override { count += events.size(); }
+
+    private:
+        std::size_t count{0};
+    };
+
+    struct Options {
+        std::size_t events = 1'000'000;                             // Events per scenario, split over the producers
+        std::vector<unsigned> threads{1, 2, 4, 8, 16, 32, 64};      // Producer counts to run
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "loggerCpp_bench";
+        std::string filter;                                         // Only scenarios whose name contains this
+        std::size_t payload = 0;                                    // Bytes of user text added to every message, 0 for none
+    };
+
+    struct Scenario {
+        std::string name;                                           // "<mode>/<sink>"
+        bool async;                                                 // Engine mode
+        bool enabled;                                               // false: calls are below the global level
+        std::function<std::shared_ptr<LogSink>()> makeSink;         // Fresh sink per run, throws if unavailable
+        bool optIn = false;                                         // Only run when --filter names it
+    };
+
+    struct Result {
+        std::string scenario;
+        unsigned threads;
+        std::size_t events;
+        double seconds;
+        std::vector<uint32_t> latencies;                            // Per call, nanoseconds, sorted
+    };
+
+    // Sends stdout to /dev/null for the lifetime of the object
+    class StdoutToDevNull {
+    public:
+        StdoutToDevNull() {
+#ifdef __unix__
+            std::fflush(stdout);
+            std::cout.flush();
+            saved = ::dup(STDOUT_FILENO);
+            const int null = ::open("/dev/null", O_WRONLY);
+            ::dup2(null, STDOUT_FILENO);
+            ::close(null);
+#endif
+        }
+
+        ~StdoutToDevNull() {
+#ifdef __unix__
+            std::fflush(stdout);
+            std::cout.flush();
+            ::dup2(saved, STDOUT_FILENO);
+            ::close(saved);
+#endif
+        }
+
+    private:
+        int saved{-1};
+    };
+
+#ifdef __unix__
+    // Bound UDP socket on the loopback interface that never reads: the kernel accepts datagrams
+    // until its buffer is full and then discards them, so senders are measured without a peer
+    class UdpDiscard {
+    public:
+        UdpDiscard() {
+            fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            socklen_t length = sizeof(address);
+            if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&address), length) != 0 ||
+                ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+                if (fd >= 0) ::close(fd);
+                throw std::runtime_error("Failed to bind a loopback UDP socket");
+            }
+            port = ntohs(address.sin_port);
+        }
+
+        ~UdpDiscard() { ::close(fd); }
+
+        UdpDiscard(const UdpDiscard&) = delete;
+        UdpDiscard& operator=(const UdpDiscard&) = delete;
+
+        uint16_t port{0};
+
+    private:
+        int fd{-1};
+    };
+#endif
+
+    uint32_t percentile(const std::vector<uint32_t>& sorted, double p) {
+        if (sorted.empty()) return 0;
+        const auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+        return sorted[index];
+    }
+
+    // Text that looks like user input: mostly clean, with a quote every 256 bytes for the escapers to find
+    std::string makePayload(std::size_t size) {
+        std::string payload(size, 'x');
+        for (std::size_t i = 0; i < size; ++i) {
+            payload[i] = i % 256 == 255 ? '"' : static_cast<char>('a' + i % 26);
+        }
+        return payload;
+    }
+
+    Result run(const Scenario& scenario, unsigned threads, std::size_t totalEvents, const std::string& payload) {
+        const auto sink = scenario.makeSink();
+        LoggingEngine& engine = LoggingEngine::getInstance();
+        engine.clearSinks();
+        if (scenario.async) {
+            engine.startAsync();
+        } else {
+            engine.stopAsync();
+        }
+        engine.setLogLevel(scenario.enabled ? utils::LogLevel::INFO : utils::LogLevel::ERROR);
+        engine.addSink(sink, utils::LogLevel::TRACE);
+
+        const std::size_t perThread = std::max<std::size_t>(totalEvents / threads, 1);
+        std::vector<std::vector<uint32_t>> latencies(threads, std::vector<uint32_t>(perThread));
+        std::latch start(threads + 1);
+
+        std::vector<std::jthread> producers;
+        producers.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) {
+            producers.emplace_back([&, t] {
+                auto& samples = latencies[t];
+                start.arrive_and_wait();
+                for (std::size_t i = 0; i < perThread; ++i) {
+                    const auto before = Clock::now();
+                    // Spelled out: <syslog.h> redefines LOG_INFO
+                    if (payload.empty()) {
+                        LOGGERCPP_LOG(utils::LogLevel::INFO, "request {} served in {:.3f} ms by worker {}", i, 0.25 * static_cast<double>(i % 1000), t);
+                    } else {
+                        LOGGERCPP_LOG(utils::LogLevel::INFO, "request {} by worker {}: {}", i, t, payload);
+                    }
+                    const auto after = Clock::now();
+                    samples[i] = static_cast<uint32_t>(std::min<int64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count(), UINT32_MAX));
+                }
+            });
+        }
+
+        start.arrive_and_wait();
+        const auto begin = Clock::now();
+        producers.clear();
+        // End to end: stopping the engine drains the queue, and the sink's buffer is written out
+        engine.stopAsync();
+        sink->flush();
+        const auto end = Clock::now();
+        engine.clearSinks();
+
+        Result result{scenario.name, threads, perThread * threads,
+                      std::chrono::duration<double>(end - begin).count(), {}};
+        result.latencies.reserve(result.events);
+        for (const auto& samples : latencies) {
+            result.latencies.insert(result.latencies.end(), samples.begin(), samples.end());
+        }
+        std::sort(result.latencies.begin(), result.latencies.end());
+        return result;
+    }
+
+    std::vector<Scenario> makeScenarios(const Options& options) {
+        const auto dir = options.directory;
+        std::vector<Scenario> scenarios;
+        for (const bool async : {false, true}) {
+            const std::string mode = async ? "async" : "sync";
+            scenarios.push_back({mode + "/disabled", async, false, [] { return std::make_shared<NullLogSink>(); }});
+            scenarios.push_back({mode + "/null", async, true, [] { return std::make_shared<NullLogSink>(); }});
+            scenarios.push_back({mode + "/console", async, true, [] { return std::make_shared<ConsoleLogSink>(); }});
+            scenarios.push_back({mode + "/file", async, true, [dir] {
+                std::filesystem::remove(dir / "bench.log");
+                return std::make_shared<FileLogSink>((dir / "bench.log").string());
+            }});
+            scenarios.push_back({mode + "/json", async, true, [dir] {
+                std::filesystem::remove(dir / "bench.json");
+                return std::make_shared<JsonLogSink>((dir / "bench.json").string());
+            }});
+            scenarios.push_back({mode + "/binary", async, true, [dir] {
+                std::filesystem::remove(dir / "bench.bin");
+                return std::make_shared<BinaryLogSink>((dir / "bench.bin").string());
+            }});
+#ifdef __unix__
+            scenarios.push_back({mode + "/mmap", async, true, [dir] {
+                for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+                    if (entry.path().filename().string().starts_with("bench-mmap")) std::filesystem::remove(entry.path());
+                }
+                return std::make_shared<MmapFileLogSink>((dir / "bench-mmap").string());
+            }});
+            scenarios.push_back({mode + "/network", async, true, [] {
+                // One collector for all runs; the sink is the part being measured
+                static UdpDiscard collector;
+                return std::make_shared<NetworkLogSink>(fmt::format("udp://127.0.0.1:{}", collector.port));
+            }});
+            // Goes to the system's syslog daemon, so it is only run when asked for by name
+            scenarios.push_back({mode + "/syslog", async, true, [] {
+                return std::make_shared<SysLogSink>("loggerCpp_bench");
+            }, true});
+#endif
+            scenarios.push_back({mode + "/database", async, true, [dir] {
+                for (const char* suffix : {"", "-wal", "-shm"}) {
+                    std::filesystem::remove(dir / (std::string("bench.db") + suffix));
+                }
+                return std::make_shared<DataBaseLogSink>((dir / "bench.db").string());
+            }});
+        }
+        return scenarios;
+    }
+
+    void printResult(std::FILE* out, const Result& result, bool first) {
+        fmt::print(out,
+            "{}    {{\"scenario\": \"{}\", \"threads\": {}, \"events\": {}, \"seconds\": {:.6f}, "
+            "\"events_per_second\": {:.0f}, \"latency_ns\": {{\"p50\": {}, \"p99\": {}, \"p999\": {}, \"max\": {}}}}}",
+            first ? "" : ",\n",
+            result.scenario, result.threads, result.events, result.seconds,
+            static_cast<double>(result.events) / result.seconds,
+            percentile(result.latencies, 0.50), percentile(result.latencies, 0.99),
+            percentile(result.latencies, 0.999), result.latencies.empty() ? 0 : result.latencies.back());
+    }
+
+    void printUsage() {
+        std::fputs("Usage: loggerCpp_bench [--events N] [--threads 1,2,4] [--dir PATH] [--filter TEXT] [--payload BYTES]\n"
+                   "Prints results as JSON on stdout. --payload adds that much user text to every message.\n"
+                   "The syslog scenarios only run when --filter selects them.\n", stderr);
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            if (i + 1 >= argc) return false;
+            const std::string_view value = argv[++i];
+            if (arg == "--events") {
+                options.events = std::strtoull(value.data(), nullptr, 10);
+            } else if (arg == "--threads") {
+                options.threads.clear();
+                for (std::size_t pos = 0; pos <= value.size();) {
+                    const std::size_t comma = std::min(value.find(',', pos), value.size());
+                    const unsigned count = static_cast<unsigned>(std::strtoul(std::string(value.substr(pos, comma - pos)).c_str(), nullptr, 10));
+                    if (count != 0) options.threads.push_back(count);
+                    pos = comma + 1;
+                }
+            } else if (arg == "--dir") {
+                options.directory = value;
+            } else if (arg == "--filter") {
+                options.filter = value;
+            } else if (arg == "--payload") {
+                options.payload = std::strtoull(value.data(), nullptr, 10);
+            } else {
+                return false;
+            }
+        }
+        return options.events != 0 && !options.threads.empty();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+    std::filesystem::create_directories(options.directory);
+
+    const std::string payload = makePayload(options.payload);
+    std::vector<Result> results;
+    for (const auto& scenario : makeScenarios(options)) {
+        if (options.filter.empty() ? scenario.optIn : scenario.name.find(options.filter) == std::string::npos) continue;
+        for (const unsigned threads : options.threads) {
+            fmt::print(stderr, "{} x{}...\n", scenario.name, threads);
+            try {
+                StdoutToDevNull quiet;
+                results.push_back(run(scenario, threads, options.events, payload));
+            } catch (const std::exception& e) {
+                // A sink left out of this build (DataBaseLogSink without SQLite) or unavailable here
+                fmt::print(stderr, "{} skipped: {}\n", scenario.name, e.what());
+                break;
+            }
+        }
+    }
+
+    const auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+    fmt::print("{{\n  \"benchmark\": \"loggerCpp\",\n  \"unix_time\": {},\n  \"hardware_threads\": {},\n  \"payload_bytes\": {},\n  \"results\": [\n",
+               now.count(), std::thread::hardware_concurrency(), options.payload);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        printResult(stdout, results[i], i == 0);
+    }
+    fmt::print("\n  ]\n}}\n");
+    return 0;
+}
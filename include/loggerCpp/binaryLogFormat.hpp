@@ -0,0 +1,166 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Layout of the files written by BinaryLogSink
+ *
+ * A file is a sequence of records, each starting with a type byte:
+ *
+ *   SESSION     magic "LCPPBIN", version byte. Starts every run appended to the file and
+ *               resets the call-site dictionary and the timestamp base.
+ *   CALL_SITE   id, line, column, flags, file, function, format string. Written once per
+ *               session, before the first event that refers to it.
+ *   EVENT|level call-site id, timestamp delta to the previous event (zigzag), argument bytes.
+ *
+ * Integers are LEB128 varints and strings are a varint length followed by the bytes. Event
+ * arguments use the ArgTag tags of formatArgs.hpp with compact values: varints for integers and
+ * pointers, 4 bytes for float and 8 for other floating point (long double is narrowed to double). Fields follow the
+ * positional arguments as a FIELD tag, the key string and the tagged value. Events of
+ * PREFORMATTED call sites carry the rendered message as a single string argument.
+ */
+struct BinaryLogFormat {
+    static constexpr char MAGIC[7] = {'L', 'C', 'P', 'P', 'B', 'I', 'N'};  /**< Follows the SESSION type byte */
+    static constexpr uint8_t VERSION = 1;                                 /**< Layout version */
+    static constexpr uint8_t PREFORMATTED = 0x01;                         /**< Call-site flag: events carry their text */
+
+    /**
+     * @brief Record type, the high nibble of the first byte of a record
+     */
+    enum class Record : uint8_t {
+        SESSION = 0x00,     /**< Start of a session */
+        CALL_SITE = 0x10,   /**< Call-site dictionary entry */
+        EVENT = 0x20        /**< Log event, the low nibble holds its LogLevel */
+    };
+
+    /**
+     * @brief Appends @p value as an unsigned LEB128 varint
+     */
+    static void putVarint(fmt::memory_buffer& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    /**
+     * @brief Appends a varint length followed by the bytes of @p text
+     */
+    static void putString(fmt::memory_buffer& out, std::string_view text) {
+        putVarint(out, text.size());
+        out.append(text);
+    }
+
+    /**
+     * @brief Maps signed values to unsigned ones so small magnitudes stay short
+     */
+    static constexpr uint64_t zigzag(int64_t value) noexcept {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    /**
+     * @brief Inverse of zigzag
+     */
+    static constexpr int64_t unzigzag(uint64_t value) noexcept {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+};
+
+/**
+ * @brief Sequential reader of BinaryLogSink files, used by the loggerCpp-decode tool
+ */
+class BinaryLogReader {
+public:
+    /**
+     * @brief A call-site dictionary entry
+     */
+    struct CallSite {
+        std::string file;           /**< Source file */
+        std::string function;       /**< Enclosing function */
+        uint32_t line{0};           /**< Source line */
+        uint32_t column{0};         /**< Source column */
+        std::string format;         /**< Format string, empty for preformatted call sites */
+        bool preformatted{false};   /**< Whether events carry their rendered text */
+    };
+
+    /**
+     * @brief One decoded event
+     */
+    struct Event {
+        utils::LogLevel level{utils::LogLevel::NONE};   /**< Log level */
+        uint64_t timestamp{0};                          /**< Nanoseconds since the Unix epoch */
+        const CallSite* site{nullptr};                  /**< Where the event was logged */
+        std::string_view message;                       /**< Rendered message, valid until the next call to next() */
+    };
+
+    /**
+     * @brief Opens a file written by BinaryLogSink
+     * @param path Path of the file
+     * @throws std::runtime_error if the file cannot be opened or does not start with a session
+     */
+    explicit BinaryLogReader(std::string_view path);
+
+    /**
+     * @brief Decodes the next event
+     * @param event Receives the event
+     * @return false at the end of the file; see truncated() for an incomplete last record
+     * @throws std::runtime_error on a malformed record
+     */
+    bool next(Event& event);
+
+    /**
+     * @brief Whether reading stopped on a record cut short, e.g. by a crash while writing
+     */
+    [[nodiscard]] bool truncated() const noexcept { return cutShort; }
+
+private:
+    /**
+     * @brief Reads a varint, throwing at end of file
+     */
+    uint64_t readVarint();
+
+    /**
+     * @brief Reads a length-prefixed string into @p out
+     */
+    void readString(std::string& out);
+
+    /**
+     * @brief Reads exactly @p size bytes into @p out
+     */
+    void readBytes(char* out, std::size_t size);
+
+    /**
+     * @brief Reads the rest of a SESSION record and resets the per-session state
+     */
+    void readSession();
+
+    /**
+     * @brief Reads the rest of a CALL_SITE record into the dictionary
+     */
+    void readCallSite();
+
+    /**
+     * @brief Renders the compact arguments of an event into message
+     * @param site Call site of the event
+     */
+    void renderMessage(const CallSite& site);
+
+    std::ifstream file;                                         /**< Input file */
+    std::vector<CallSite> callSites;                            /**< Dictionary of the current session, indexed by id */
+    uint64_t lastTimestamp{0};                                  /**< Base of the next timestamp delta */
+    std::string args;                                           /**< Compact argument bytes of the current event */
+    fmt::dynamic_format_arg_store<fmt::format_context> store;   /**< Decoded arguments of the current event */
+    fmt::memory_buffer message;                                 /**< Rendered message of the current event */
+    fmt::memory_buffer fields;                                  /**< " key=value" text of the current event's fields */
+    bool cutShort{false};                                       /**< Set when the last record is incomplete */
+};
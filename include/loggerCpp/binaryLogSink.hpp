@@ -0,0 +1,91 @@
+#pragma once
+
+#include "logSink.hpp"
+#include "fileLogSink.hpp"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Compact binary file sink
+ *
+ * Writes structured records instead of text lines: level, timestamp delta, an interned
+ * call-site id and the event's arguments, see BinaryLogFormat. File, function, line and format
+ * string of a call site are written once per run. Deferred events are stored without their
+ * rendered text; the loggerCpp-decode tool turns the file back into text or JSON.
+ */
+class BinaryLogSink final : public LogSink {
+public:
+    /**
+     * @brief Constructs a BinaryLogSink appending a new session to the given file
+     *
+     * @param fileName The name/path of the file to write to
+     * @param policy When buffered output is written to the file
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    explicit BinaryLogSink(std::string_view fileName, const FileFlushPolicy& policy = {});
+
+    /**
+     * @brief Writes out buffered records before closing the file
+     */
+    ~BinaryLogSink() noexcept override;
+
+    /**
+     * @brief Writes a log event to the file
+     *
+     * @param event The log event to be written
+     */
+    void write(const utils::LogEvent& event) override;
+
+    /**
+     * @brief Encodes a batch of log events, writing the buffer once a trigger of the policy fires
+     *
+     * @param events The events to be written, in order
+     */
+    void writeBatch(std::span<const utils::LogEvent> events) override;
+
+    /**
+     * @brief Writes buffered records to the file
+     */
+    void flush() override;
+
+private:
+    static constexpr uint32_t NOT_WRITTEN = UINT32_MAX;    /**< callSites value of a site without a CALL_SITE record yet */
+
+    /**
+     * @brief Appends one EVENT record, preceded by a CALL_SITE record the first time
+     * @param event The event to encode
+     */
+    void appendEvent(const utils::LogEvent& event);
+
+    /**
+     * @brief Dictionary id of the event's call site, writing its CALL_SITE record if it is new
+     * @param event The event being encoded
+     */
+    uint32_t callSiteId(const utils::LogEvent& event);
+
+    /**
+     * @brief Re-encodes the event's arguments in the compact file encoding into args
+     * @param event The event being encoded
+     */
+    void encodeArgs(const utils::LogEvent& event);
+
+    /**
+     * @brief Writes the buffer to the file with a single call
+     */
+    void writeBuffer();
+
+    std::ofstream file;                                                 /**< Output file */
+    FileFlushPolicy policy;                                             /**< When the buffer is written out */
+    std::chrono::steady_clock::time_point lastFlush;                    /**< Time of the last write */
+    fmt::memory_buffer buffer;                                          /**< Encoded records waiting to be written */
+    fmt::memory_buffer args;                                            /**< Scratch for one event's arguments */
+    std::vector<uint32_t> callSites;                                    /**< Dictionary id by 2 * CallSite id + preformatted */
+    uint32_t nextCallSite{0};                                           /**< Dictionary id of the next new call site */
+    uint64_t lastTimestamp{0};                                          /**< Base of the next timestamp delta */
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+namespace utils {
+
+    /**
+     * @brief Process-wide pool of overflow buffers for log events
+     *
+     * Messages and argument payloads that do not fit inline in a LogEvent borrow a fixed-size
+     * block from this pool. Released blocks go back to a lock-free free list, so in steady state
+     * long messages cost no allocator calls. Requests larger than a block fall back to the heap.
+     */
+    class BufferPool {
+    public:
+        static constexpr std::size_t BLOCK_SIZE = 4096;    /**< Size of a pooled block in bytes */
+        static constexpr std::size_t MAX_POOLED = 1024;    /**< Blocks kept on the free list at most */
+
+        /**
+         * @brief Borrows a buffer of at least @p size bytes
+         * @param size Requested size in bytes
+         * @param capacity Receives the actual capacity of the returned buffer
+         * @return The buffer, or nullptr if memory is exhausted
+         */
+        [[nodiscard]] static char* acquire(std::size_t size, std::size_t& capacity) noexcept;
+
+        /**
+         * @brief Returns a buffer obtained from acquire
+         * @param buffer The buffer to release, may be nullptr
+         * @param capacity The capacity reported by acquire
+         */
+        static void release(char* buffer, std::size_t capacity) noexcept;
+    };
+
+} // namespace utils
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+    enum class LogLevel : uint8_t;
+
+    /**
+     * @brief Static description of one LOG_* call site
+     *
+     * Every LOG_* expansion defines one as a function-local static, constant-initialized
+     * from std::source_location, and registers it with CallSiteRegistry on its first enabled
+     * call. Events then carry only the small integer id, and sinks can cache whatever they
+     * render from the location per id instead of per event.
+     */
+    struct CallSite {
+        static constexpr uint32_t UNREGISTERED = 0;     /**< id slot value before registration */
+
+        LogLevel level;             /**< Level of the call */
+        const char* file;           /**< source_location::file_name() */
+        const char* function;       /**< source_location::function_name() */
+        uint32_t line;              /**< Source line */
+        uint32_t column;            /**< Source column */
+        std::string_view format;    /**< Format string literal, null if the call's format is not one */
+
+        /**
+         * @brief Describes a call site
+         * @param level Level of the call
+         * @param location Location of the call
+         * @param format Format string with static storage, or a null view
+         */
+        constexpr CallSite(LogLevel level, const std::source_location& location, std::string_view format) noexcept
+            : level(level), file(location.file_name()), function(location.function_name()),
+              line(location.line()), column(location.column()), format(format) {}
+
+        CallSite(const CallSite&) = delete;
+        CallSite& operator=(const CallSite&) = delete;
+
+        /**
+         * @brief Registry id of this site, registering it on first use
+         */
+        [[nodiscard]] uint32_t id() const noexcept;
+
+        mutable std::atomic<uint32_t> slot{UNREGISTERED};   /**< Registry id, UNREGISTERED until the first id() */
+    };
+
+    /**
+     * @brief Format string literal of a LOG_* call, a null view for anything else
+     *
+     * Only string literals are stored in a CallSite: they have static storage and the same
+     * text on every call of the site.
+     */
+    template<std::size_t N>
+    [[nodiscard]] constexpr std::string_view literalFormat(const char (&format)[N]) noexcept { return {format, N - 1}; }
+
+    template<std::size_t N>
+    [[nodiscard]] constexpr std::string_view literalFormat(char (&)[N]) noexcept { return {}; }
+
+    template<typename T>
+    [[nodiscard]] constexpr std::string_view literalFormat(const T&) noexcept { return {}; }
+
+    /**
+     * @brief Process-wide table of call sites, indexed by id
+     *
+     * Ids are dense and start at 1; id 0 is a site without a location. Sites are registered
+     * under a mutex once each, and never removed. Lookups take no lock: an id only reaches
+     * another thread through the event that carries it, after its entry was written.
+     */
+    class CallSiteRegistry {
+    public:
+        static constexpr std::size_t CHUNK_SIZE = 1024;     /**< Entries per lazily allocated chunk */
+        static constexpr std::size_t MAX_CHUNKS = 4096;     /**< Up to about four million sites */
+
+        /**
+         * @brief Site registered under an id
+         * @param id Id returned by CallSite::id()
+         */
+        [[nodiscard]] static const CallSite& get(uint32_t id) noexcept {
+            return *chunks[id / CHUNK_SIZE][id % CHUNK_SIZE];
+        }
+
+        /**
+         * @brief Registers a site with static storage, unless it already has an id
+         * @param site The site
+         * @return Its id, 0 if the registry is full
+         */
+        static uint32_t add(const CallSite& site) noexcept;
+
+        /**
+         * @brief Site for a location known only at run time, created on first use
+         *
+         * For events not created by the LOG_* macros. Sites are looked up by location, level
+         * and format pointer, first in a per-thread cache and then under a mutex. Every
+         * distinct key creates a site that is never freed, so the format must be a string
+         * literal (or nullptr), never a buffer built at run time.
+         *
+         * @param level Level of the call
+         * @param location Location of the call
+         * @param format Format string literal, or nullptr
+         */
+        static const CallSite& intern(LogLevel level, const std::source_location& location, const char* format) noexcept;
+
+        /**
+         * @brief Number of ids handed out so far, id 0 included
+         */
+        [[nodiscard]] static std::size_t size() noexcept;
+
+    private:
+        /**
+         * @brief add() with the registry mutex held
+         */
+        static uint32_t addLocked(const CallSite& site) noexcept;
+
+        static const CallSite UNKNOWN;                              /**< Site of id 0 */
+        static const CallSite* firstChunk[CHUNK_SIZE];              /**< Chunk 0, holds UNKNOWN */
+        static const CallSite** chunks[MAX_CHUNKS];                 /**< Entry chunks, allocated as ids grow */
+    };
+
+    inline uint32_t CallSite::id() const noexcept {
+        const uint32_t id = slot.load(std::memory_order_acquire);
+        return id != UNREGISTERED ? id : CallSiteRegistry::add(*this);
+    }
+
+    /**
+     * @brief Per-sink cache of text rendered once per call site
+     *
+     * Not thread-safe: each sink owns its cache and uses it from the thread that writes it.
+     */
+    class CallSiteTextCache {
+    public:
+        /**
+         * @brief Text of a site, rendering it on first use
+         * @param id Call site id
+         * @param render Callable (const CallSite&, std::string&) filling in the text
+         */
+        template<typename Render>
+        [[nodiscard]] std::string_view get(uint32_t id, Render&& render) {
+            if (id >= texts.size()) [[unlikely]] {
+                texts.resize(id + 1);
+                rendered.resize(id + 1);
+            }
+            if (!rendered[id]) [[unlikely]] {
+                render(CallSiteRegistry::get(id), texts[id]);
+                rendered[id] = true;
+            }
+            return texts[id];
+        }
+
+    private:
+        std::vector<std::string> texts;     /**< Rendered text by id */
+        std::vector<bool> rendered;         /**< Whether texts[id] is filled in */
+    };
+
+} // namespace utils
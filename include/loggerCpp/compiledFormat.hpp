@@ -0,0 +1,105 @@
+#pragma once
+
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief Format argument of a LOG_* expansion
+ *
+ * A string literal becomes a utils::CompiledFormat, whose type carries the text: the engine
+ * checks it against the argument types at compile time and formats it with code generated
+ * for it. Anything else (std::string, const char*, ...) is passed through and formatted at
+ * run time.
+ */
+#define LOGGERCPP_FORMAT(msg) \
+    [&]<typename loggerCppFormatType = decltype((msg))>() -> decltype(auto) { \
+        if constexpr (utils::isLiteralFormat<loggerCppFormatType>) { \
+            return utils::CompiledFormat<utils::FixedString(static_cast<loggerCppFormatType>(msg))>{}; \
+        } else { \
+            return (msg); \
+        } \
+    }()
+
+namespace utils {
+
+    namespace detail {
+#if FMT_VERSION >= 110000
+        using CompiledStringBase = fmt::compiled_string;
+#else
+        using CompiledStringBase = fmt::detail::compiled_string;
+#endif
+    } // namespace detail
+
+    /**
+     * @brief String literal usable as a template argument
+     */
+    template<std::size_t N>
+    struct FixedString {
+        char data[N]{};     /**< Characters, terminating null included */
+
+        constexpr FixedString(const char (&text)[N]) noexcept { std::copy_n(text, N, data); }
+
+        [[nodiscard]] constexpr std::string_view view() const noexcept { return {data, N - 1}; }
+    };
+
+    /**
+     * @brief Format string known at compile time, as produced by FMT_COMPILE
+     *
+     * fmt parses it while compiling and turns each replacement field into a direct call to
+     * the argument's formatter, so nothing is parsed per call.
+     */
+    template<FixedString Format>
+    struct CompiledFormat : detail::CompiledStringBase {
+        using char_type = char;
+
+        static constexpr std::string_view text = Format.view();    /**< The format string */
+
+        constexpr explicit operator fmt::string_view() const noexcept { return {text.data(), text.size()}; }
+    };
+
+    /**
+     * @brief Whether the type of a format expression (as given by decltype((msg))) is a string literal
+     */
+    template<typename T>
+    inline constexpr bool isLiteralFormat = false;
+
+    template<std::size_t N>
+    inline constexpr bool isLiteralFormat<const char (&)[N]> = true;
+
+    /**
+     * @brief Whether a format is a CompiledFormat
+     */
+    template<typename T>
+    inline constexpr bool isCompiledFormat = fmt::detail::is_compiled_string<T>::value;
+
+    /**
+     * @brief Text of a compiled or run-time format
+     */
+    template<typename Format>
+    [[nodiscard]] constexpr fmt::string_view formatText(const Format& format) noexcept {
+        if constexpr (isCompiledFormat<Format>) {
+            return static_cast<fmt::string_view>(format);
+        } else {
+            return format;
+        }
+    }
+
+    /**
+     * @brief Formats into a buffer with fmt's compiled path when the format is a CompiledFormat
+     * @throws fmt::format_error on a bad run-time format string or argument
+     */
+    template<typename Format, typename... Args>
+    void formatTo(fmt::memory_buffer& out, const Format& format, const Args&... args) {
+        if constexpr (isCompiledFormat<Format>) {
+            fmt::format_to(fmt::appender(out), format, args...);
+        } else {
+            fmt::vformat_to(fmt::appender(out), format, fmt::make_format_args(args...));
+        }
+    }
+
+} // namespace utils
@@ -1,4 +1,6 @@
 #pragma once
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <string_view>
 
@@ -11,6 +13,12 @@
  * This class manages the configuration of the logging system, including setting up
  * different types of logging sinks (console, file, network, database) and their 
  * associated log levels.
+ *
+ * With a single level, the sink receives that level and everything above it. With several
+ * levels, one sink is created and receives exactly the listed levels.
+ *
+ * Alternatively the whole setup can be described in a JSON file, see loadConfigFile(), and
+ * reloaded whenever the file changes, see watchConfigFile().
  */
 class ConfigurationManager {
 public:
@@ -20,9 +28,9 @@ public:
     ConfigurationManager();
 
     /**
-     * @brief Virtual destructor
+     * @brief Destructor, stops watching the configuration file
      */
-    ~ConfigurationManager() noexcept = default;
+    ~ConfigurationManager() noexcept;
 
     /**
      * @brief Deleted copy constructor to prevent copying
@@ -38,13 +46,13 @@ public:
      * @brief Move constructor
      * @note Allows efficient transfer of resources
      */
-    ConfigurationManager(ConfigurationManager&&) noexcept = default;
+    ConfigurationManager(ConfigurationManager&&) noexcept;
 
     /**
      * @brief Move assignment operator
      * @return Reference to the moved ConfigurationManager
      */
-    ConfigurationManager& operator=(ConfigurationManager&&) noexcept = default;
+    ConfigurationManager& operator=(ConfigurationManager&&) noexcept;
 
     /**
      * @brief Constructs a ConfigurationManager with specified log level
@@ -52,6 +60,63 @@ public:
      */
     explicit ConfigurationManager(const utils::LogLevel& logLevel);
 
+    /**
+     * @brief Applies a JSON configuration file: global level, async mode, queue policy, sinks and logger levels
+     *
+     * @code
+     * {
+     *   "level": "INFO",
+     *   "async": true,
+     *   "formatMode": "DEFERRED",
+     *   "queue": { "capacity": 16384, "overflow": "DROP_OLDEST" },
+     *   "sinks": [
+     *     { "type": "console", "level": "WARNING" },
+     *     { "type": "file", "path": "app.log", "levels": ["INFO", "ERROR"],
+     *       "flush": { "bufferBytes": 65536, "intervalMs": 1000, "level": "ERROR" },
+     *       "rotation": { "maxBytes": 104857600, "maxFiles": 10 }, "index": { "blockBytes": 65536 } },
+     *     { "type": "network", "url": "tcp://collector:6514", "format": "JSON_LINES", "isolated": true }
+     *   ],
+     *   "loggers": { "net.http": "DEBUG", "db.pool": "WARNING" }
+     * }
+     * @endcode
+     *
+     * Sink types are console, file, mmap, binary, json, network, database and syslog; each takes
+     * the options of its constructor, "level" (minimum) or "levels" (exact set), and "isolated"
+     * (true or IsolatedSinkOptions) to run it on its own thread. "loggers" sets the level of named
+     * Logger handles; a logger dropped from the list on a later load inherits again. Top-level
+     * keys left out keep their current setting.
+     *
+     * The sink set replaces the previous one in a single swap (LoggingEngine::setSinks()).
+     * Sinks whose description did not change since the previous load are kept, not reopened.
+     * A changed sink is a new instance; when it writes to the path of one being dropped, the
+     * old one is unrouted and closed first, so the file never has two writers. Events routed
+     * to that path in between are not written.
+     *
+     * @param path The configuration file
+     * @throws std::runtime_error if the file cannot be read, is invalid, a sink cannot be
+     *         created, or the library was built without nlohmann/json; the previous sinks are
+     *         kept (those closed for their path are reopened) and nothing else is changed then
+     */
+    void loadConfigFile(const std::filesystem::path& path);
+
+    /**
+     * @brief Applies a JSON configuration file, then reapplies it whenever it changes
+     *
+     * A background thread waits on inotify for the file to be written, replaced or renamed into
+     * place, and reloads it like loadConfigFile(). Sinks are created on that thread and swapped
+     * in atomically, so producers never wait for a reload. A file that fails to load leaves the
+     * running configuration in place and is reported as an ERROR event.
+     *
+     * @param path The configuration file
+     * @throws std::runtime_error like loadConfigFile(), or if the file cannot be watched
+     */
+    void watchConfigFile(const std::filesystem::path& path);
+
+    /**
+     * @brief Stops reloading the configuration file; the current configuration stays in effect
+     */
+    void stopWatching() noexcept;
+
     /**
      * @brief Configures and adds multiple console sinks to the logger
      * @param level1 First log level
@@ -98,12 +163,12 @@ public:
 
     /**
      * @brief Configures and adds multiple database sinks to the logger
-     * @param database The database connection string
+     * @param database Path of the SQLite database file, created with its schema if missing
      * @param level1 First log level
      * @param level2 Second log level
      * @param level3 Third log level (optional)
      * @param level4 Fourth log level (optional)
-     * @throws std::runtime_error if database connection fails or sink creation fails
+     * @throws std::runtime_error if the database cannot be opened or the library was built without SQLite
      */
     void applyDataBaseSink(const utils::LogLevel& level, const std::string_view& database);
     [[maybe_unused]] void applyDataBaseSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const std::string_view& database);
@@ -126,4 +191,9 @@ public:
     [[maybe_unused]] void applySysLogSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const std::string_view& ident);
     [[maybe_unused]] void applySysLogSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const utils::LogLevel& level5, const std::string_view& ident);
     #endif
+
+private:
+    class ConfigFile;
+
+    std::unique_ptr<ConfigFile> configFile; /**< Loaded configuration file, its sinks and watcher */
 };
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "logSink.hpp"
+#include "timestampFormatter.hpp"
+
+#include <fmt/format.h>
 
 #include <string_view>
 #include <fstream>
@@ -30,4 +33,22 @@ public:
      * console stream (stdout for regular logs, stderr for errors).
      */
     void write(const utils::LogEvent& event) override;
+
+    /**
+     * @brief Writes a batch of log events with a single write
+     *
+     * @param events The events to be written, in order
+     */
+    void writeBatch(std::span<const utils::LogEvent> events) override;
+
+private:
+    /**
+     * @brief Appends the text form of one event to buffer
+     * @param event The event to render
+     */
+    void appendEvent(const utils::LogEvent& event);
+
+    utils::TimestampFormatter timestampFormatter;  /**< Cached renderer for event timestamps */
+    utils::CallSiteTextCache locations;            /**< Location text rendered once per call site */
+    fmt::memory_buffer buffer;                     /**< Reused output buffer for a batch */
 };
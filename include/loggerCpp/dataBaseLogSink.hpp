@@ -1,36 +1,119 @@
 #pragma once
 
-#include "logSink.hpp"  
+#include "logSink.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+/**
+ * @brief Transaction batching of a DataBaseLogSink
+ */
+struct DataBaseSinkOptions {
+    std::size_t batchRows = 1024;                       /**< Rows per transaction before it is committed */
+    std::chrono::milliseconds commitInterval{200};      /**< Longest a transaction stays open once it has rows */
+};
 
 /**
  * @brief Database output sink for logging
- * 
- * This class implements a logging sink that writes log messages to a database.
- * It inherits from the LogSink base class and provides database-specific logging functionality.
+ *
+ * Writes events into an embedded SQLite database file, creating it and its schema on first
+ * use:
+ *
+ * @code
+ * CREATE TABLE logs (id INTEGER PRIMARY KEY, timestamp INTEGER NOT NULL, level INTEGER NOT NULL,
+ *                    file TEXT, line INTEGER, function TEXT, message TEXT NOT NULL);
+ * CREATE INDEX logs_timestamp ON logs(timestamp);
+ * CREATE INDEX logs_level ON logs(level);
+ * @endcode
+ *
+ * timestamp is nanoseconds since the Unix epoch, level the utils::LogLevel value. The database
+ * runs in WAL mode so readers do not block the logger. Rows go through one prepared INSERT and
+ * are grouped into transactions of up to batchRows rows, committed at the latest commitInterval
+ * after the first row, or when the logging thread flushes; a transaction per row would cap
+ * the sink at the disk's fsync rate.
+ *
+ * Needs the library to be built with SQLite (LOGGERCPP_WITH_SQLITE); otherwise construction throws.
  */
 class DataBaseLogSink final : public LogSink {
 public:
     /**
-     * @brief Default constructor
-     * 
-     * Constructs a DataBaseLogSink object that can write log messages to a database.
+     * @brief Opens or creates the database and prepares the insert statement
+     *
+     * @param database Path of the SQLite database file
+     * @param options Transaction batching
+     * @throws std::runtime_error If the database cannot be opened or its schema created
      */
-    DataBaseLogSink() noexcept = default;   
+    explicit DataBaseLogSink(std::string_view database, const DataBaseSinkOptions& options = {});
 
     /**
-     * @brief Constructor with database name
-     * 
-     * Constructs a DataBaseLogSink object that can write log messages to a database.
+     * @brief Commits the open transaction and closes the database
      */
-    DataBaseLogSink(const std::string_view& database);
+    ~DataBaseLogSink() noexcept override;
 
     /**
-     * @brief Writes a log event to the database
-     * 
+     * @brief Inserts a log event into the open transaction
+     *
      * @param event The log event containing the message and metadata to be written
-     * @throws None This function is noexcept
-     * 
-     * This function formats and writes the provided log event to the configured database.
+     * @throws std::runtime_error If the insert or a due commit fails
      */
     void write(const utils::LogEvent& event) override;
-};
\ No newline at end of file
+
+    /**
+     * @brief Inserts a batch of log events, committing whenever batchRows is reached
+     *
+     * Neither a failing row nor a failing commit stops the batch: after a busy commit the
+     * remaining rows go into the open transaction, which the next commit retries. The errors
+     * are thrown once the whole batch is inserted.
+     *
+     * @param events The events to be written, in order
+     * @throws std::runtime_error If an insert or a commit fails
+     */
+    void writeBatch(std::span<const utils::LogEvent> events) override;
+
+    /**
+     * @brief Commits the open transaction, if any
+     *
+     * @throws std::runtime_error If the commit fails
+     */
+    void flush() override;
+
+private:
+    /**
+     * @brief Runs SQL without results, throwing with the database's message on failure
+     * @param sql Statements to run
+     */
+    void execute(const char* sql);
+
+    /**
+     * @brief Inserts one row, opening a transaction first if none is open
+     * @param event The event to insert
+     * @return false if the insert failed
+     */
+    bool insert(const utils::LogEvent& event) noexcept;
+
+    /**
+     * @brief Commits the open transaction if it is full or has been open for commitInterval
+     */
+    void commitIfDue();
+
+    /**
+     * @brief Commits the open transaction
+     */
+    void commit();
+
+    DataBaseSinkOptions options;                                /**< Transaction batching */
+    sqlite3* db{nullptr};                                       /**< Database connection */
+    sqlite3_stmt* insertStatement{nullptr};                     /**< Prepared INSERT */
+    sqlite3_stmt* beginStatement{nullptr};                      /**< Prepared BEGIN */
+    sqlite3_stmt* commitStatement{nullptr};                     /**< Prepared COMMIT */
+    std::size_t openRows{0};                                    /**< Rows in the open transaction, 0 when none is open */
+    bool inTransaction{false};                                  /**< Whether BEGIN has run without COMMIT */
+    std::chrono::steady_clock::time_point transactionStart;     /**< When the open transaction began */
+    std::string lastError;                                      /**< Message of the last failed insert */
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "utils.hpp"
+#include "logEventRouter.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Layout of the sparse index FileLogSink writes next to a log file as "<file>.idx"
+ *
+ * The index starts with the magic "LCPPIDX" and a version byte, followed by fixed-size
+ * entries, one per block of the log file:
+ *
+ *   offset      u64  File offset of the block's first record
+ *   length      u32  Block size in bytes, whole records only
+ *   levels      u8   LevelMask of the records in the block
+ *   (padding)   3 bytes
+ *   minTime     u64  Smallest event timestamp in the block, nanoseconds since the Unix epoch
+ *   maxTime     u64  Largest event timestamp in the block
+ *
+ * All integers are little-endian. A block is closed once it reaches FileIndexPolicy::blockBytes,
+ * on rotation and when the sink is destroyed, so the end of a live file is not indexed yet;
+ * readers scan any part of the file no entry covers.
+ */
+struct FileLogIndex {
+    static constexpr char MAGIC[7] = {'L', 'C', 'P', 'P', 'I', 'D', 'X'};  /**< Start of every index file */
+    static constexpr uint8_t VERSION = 1;                                 /**< Layout version */
+    static constexpr std::size_t HEADER_SIZE = sizeof(MAGIC) + 1;         /**< Magic and version */
+    static constexpr std::size_t ENTRY_SIZE = 32;                         /**< Bytes per entry */
+
+    /**
+     * @brief One indexed block
+     */
+    struct Entry {
+        uint64_t offset{0};                                         /**< File offset of the first record */
+        uint32_t length{0};                                         /**< Block size in bytes */
+        utils::LevelMask levels{0};                                 /**< Levels present in the block */
+        uint64_t minTime{std::numeric_limits<uint64_t>::max()};     /**< Earliest timestamp in the block */
+        uint64_t maxTime{0};                                        /**< Latest timestamp in the block */
+    };
+
+    /**
+     * @brief Encodes an entry into ENTRY_SIZE bytes
+     */
+    static void encode(const Entry& entry, char* out) noexcept;
+
+    /**
+     * @brief Decodes an entry from ENTRY_SIZE bytes
+     */
+    [[nodiscard]] static Entry decode(const char* in) noexcept;
+
+    /**
+     * @brief Path of the index belonging to a log file
+     */
+    [[nodiscard]] static std::string pathFor(std::string_view logPath) { return std::string(logPath) + ".idx"; }
+};
+
+/**
+ * @brief Time and level range query over a FileLogSink file, using its sparse index
+ *
+ * Blocks whose time range or level bitmap cannot match are skipped without being read, so a
+ * query costs a pass over the index plus the matching blocks. Within a block every record is
+ * parsed and filtered exactly. Without an index the whole file is scanned.
+ *
+ * @code
+ * FileLogReader reader("app.log");
+ * reader.query({from, to, utils::levelsFrom(utils::LogLevel::ERROR)}, [](const FileLogReader::Record& record) {
+ *     std::fwrite(record.text.data(), 1, record.text.size(), stdout);
+ * });
+ * @endcode
+ */
+class FileLogReader {
+public:
+    /**
+     * @brief Records to return
+     */
+    struct Query {
+        uint64_t from{0};                                           /**< Earliest timestamp, inclusive */
+        uint64_t to{std::numeric_limits<uint64_t>::max()};          /**< Latest timestamp, inclusive */
+        utils::LevelMask levels{utils::levelsFrom(utils::LogLevel::TRACE)}; /**< Levels to return */
+    };
+
+    /**
+     * @brief One record of the log file
+     */
+    struct Record {
+        utils::LogLevel level{utils::LogLevel::NONE};   /**< Log level */
+        uint64_t timestamp{0};                          /**< Parsed from the text, millisecond precision */
+        std::string_view text;                          /**< Lines of the record as written, continuation lines tab-indented; valid during the callback */
+    };
+
+    /**
+     * @brief What a query had to read
+     */
+    struct Stats {
+        std::size_t blocks{0};          /**< Indexed blocks in the file */
+        std::size_t blocksRead{0};      /**< Blocks read, unindexed ranges included */
+        uint64_t bytesRead{0};          /**< Bytes of the log file read */
+        uint64_t matches{0};            /**< Records passed to the callback */
+    };
+
+    /**
+     * @brief Opens a log file and, if present, its index
+     * @param path Path of the log file
+     * @throws std::runtime_error if the log file cannot be opened
+     */
+    explicit FileLogReader(std::string_view path);
+
+    /**
+     * @brief Whether an index was found and loaded
+     */
+    [[nodiscard]] bool indexed() const noexcept { return hasIndex; }
+
+    /**
+     * @brief Calls back with every record in the query's time range and levels, in file order
+     * @param query Time range and levels
+     * @param callback Receives each matching record
+     * @return What the query read
+     */
+    Stats query(const Query& query, const std::function<void(const Record&)>& callback);
+
+    /**
+     * @brief Parses local time as written by FileLogSink, "YYYY-MM-DD HH:MM:SS[.fff]"
+     * @param text Text to parse
+     * @param timestamp Receives nanoseconds since the Unix epoch
+     * @return false if the text is not such a time
+     */
+    static bool parseTime(std::string_view text, uint64_t& timestamp) noexcept;
+
+private:
+    /**
+     * @brief Loads path.idx, dropping entries that point past the end of the log file
+     */
+    void loadIndex();
+
+    /**
+     * @brief Splits a byte range of the log file into records and filters them
+     * @param data Bytes of the range, starting at a record boundary
+     * @param query Time range and levels
+     * @param callback Receives each matching record
+     * @return Number of matching records
+     */
+    uint64_t scan(std::string_view data, const Query& query, const std::function<void(const Record&)>& callback);
+
+    std::string path;                           /**< Path of the log file */
+    std::ifstream file;                         /**< The log file */
+    uint64_t fileSize{0};                       /**< Size of the log file when opened */
+    std::vector<FileLogIndex::Entry> entries;   /**< Index entries sorted by offset */
+    bool hasIndex{false};                       /**< Whether an index was loaded */
+    std::string block;                          /**< Bytes of the range being scanned */
+};
@@ -1,9 +1,68 @@
 #pragma once
 
 #include "logSink.hpp"
+#include "fileLogIndex.hpp"
+#include "timestampFormatter.hpp"
 
+#include <fmt/format.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
 #include <fstream>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Flush policy of a FileLogSink
+ *
+ * Output is accumulated in a user-space buffer and written with a single system call when
+ * any trigger fires.
+ */
+struct FileFlushPolicy {
+    std::size_t bufferSize = 64 * 1024;                 /**< Flush once this many bytes are buffered */
+    std::chrono::milliseconds interval{1000};           /**< Flush when the last flush is older than this */
+    utils::LogLevel flushLevel = utils::LogLevel::ERROR; /**< Flush right away on events at or above this level */
+};
+
+/**
+ * @brief Rotation policy of a FileLogSink
+ *
+ * The active file keeps its name; rolled segments are renamed to name.1 (newest), name.2, ...
+ * The next segment is pre-opened as name.next by a background thread, so rolling over on the
+ * logging thread only swaps streams; renames, closing and deleting old segments happen off
+ * the write path.
+ */
+struct FileRotationPolicy {
+    std::size_t maxBytes = 0;                   /**< Roll when the segment reaches this size, 0 disables */
+    std::chrono::seconds interval{0};           /**< Roll at multiples of this interval since the epoch (UTC), 0 disables */
+    std::size_t maxFiles = 0;                   /**< Rolled segments kept, 0 keeps all */
+
+    /**
+     * @brief Whether any rotation trigger is configured
+     */
+    [[nodiscard]] bool enabled() const noexcept { return maxBytes != 0 || interval.count() != 0; }
+};
+
+/**
+ * @brief Sparse index written next to a FileLogSink file
+ *
+ * With blockBytes set, the sink records every block of about that many bytes in "<file>.idx":
+ * offset, length, time range and the levels present (see FileLogIndex). FileLogReader and
+ * loggerCpp-query use it to read only the blocks a time and level query can match.
+ */
+struct FileIndexPolicy {
+    std::size_t blockBytes = 0;     /**< Bytes of log per index entry, 0 disables the index */
+
+    /**
+     * @brief Whether the index is written
+     */
+    [[nodiscard]] bool enabled() const noexcept { return blockBytes != 0; }
+};
 
 /**
  * @brief File output sink for logging with buffered writes
@@ -18,21 +77,154 @@ public:
      * @brief Constructs a FileLogSink with the specified file name
      * 
      * @param fileName The name/path of the file to write logs to
+     * @param policy When buffered output is written to the file
+     * @param rotation When and how the file is rolled over
+     * @param index Sparse index written alongside the file; rolled segments keep their own
      */
-    explicit FileLogSink(std::string_view fileName);
+    explicit FileLogSink(std::string_view fileName, const FileFlushPolicy& policy = {}, const FileRotationPolicy& rotation = {},
+                         const FileIndexPolicy& index = {});
+
+    /**
+     * @brief Flushes buffered output and stops the rotation thread before closing the file
+     */
+    ~FileLogSink() noexcept override;
 
     /**
      * @brief Writes a log event to the file
      * 
      * @param event The log event containing the message and metadata to be written
-     * @throws std::runtime_error if file write fails
+     * @throws std::runtime_error if writing buffered output to the file failed; that output is
+     *         dropped and the next write tries again
      * 
      * This function formats and writes the provided log event to the configured file
      * using buffered writes for better performance.
      */
     void write(const utils::LogEvent& event) override;
 
+    /**
+     * @brief Buffers a batch of log events, writing them out when the flush policy triggers
+     *
+     * @param events The events to be written, in order
+     * @throws std::runtime_error like write(), once the whole batch is buffered
+     */
+    void writeBatch(std::span<const utils::LogEvent> events) override;
+
+    /**
+     * @brief Writes all buffered output to the file
+     *
+     * @throws std::runtime_error like write()
+     */
+    void flush() override;
+
 private:
+    /**
+     * @brief Appends the text form of one event to buffer
+     *
+     * Every line after the first of a multi-line message starts with a tab, which keeps
+     * record boundaries unambiguous for FileLogReader.
+     *
+     * @param event The event to render
+     */
+    void appendEvent(const utils::LogEvent& event);
+
+    /**
+     * @brief Writes the buffer to the current segment without touching rotation state
+     *
+     * Does not throw: a failed write drops the buffer, clears the stream and is recorded for
+     * throwWriteError().
+     */
+    void writeBuffer();
+
+    /**
+     * @brief Throws, once, the failure recorded by writeBuffer() since the last call
+     */
+    void throwWriteError();
+
+    /**
+     * @brief Turns the open block into an index entry, to be written with the next writeBuffer()
+     */
+    void closeBlock() noexcept;
+
+    /**
+     * @brief Opens an index file, writing the header if it is empty
+     * @param stream Stream to open
+     * @param indexPath Path of the index
+     * @param mode std::ios::app to continue an index, std::ios::trunc for a fresh one
+     */
+    static void openIndex(std::ofstream& stream, const std::string& indexPath, std::ios::openmode mode);
+
+    /**
+     * @brief Switches to the pre-opened next segment if it is ready
+     * @return false if the rotation thread has not prepared it yet, the caller retries later
+     */
+    bool rotate();
+
+    /**
+     * @brief Whether rotate() has a segment to switch to
+     *
+     * When the rotation thread failed to set one up, asks it to try again, with a backoff,
+     * and reports the stall once.
+     */
+    bool rotationReady();
+
+    /**
+     * @brief Computes the next wall-clock rotation point for interval-based rotation
+     */
+    void scheduleRotation() noexcept;
+
+    /**
+     * @brief Body of the rotation thread: renames retired segments and pre-opens the next one
+     * @param stop Stop token of the thread
+     */
+    void rotationLoop(std::stop_token stop);
+
+    /**
+     * @brief Opens a fresh name.next and publishes it for the logging thread
+     * @return false if it could not be opened
+     */
+    bool prepareNextSegment();
+
+    /**
+     * @brief Applies retention, shifts name.N to name.N+1, name to name.1 and name.next to name
+     * @return false if the active segment could not be renamed
+     */
+    bool shiftSegments();
+
+    /**
+     * @brief Renames name.next, the active segment, to name
+     * @return false if the rename failed
+     */
+    bool promoteNext();
+
+    /**
+     * @brief Path of the rolled segment with the given index
+     */
+    [[nodiscard]] std::string segmentPath(std::size_t index) const;
+
     alignas(64) std::ofstream fileName;  /**< Output file stream with cache line alignment */
-    static constexpr std::size_t BUFFER_SIZE = 8192; /**< Size of write buffer in bytes (8KB) */
-};
\ No newline at end of file
+    std::string path;                              /**< Path of the active file */
+    FileFlushPolicy policy;                        /**< Flush triggers */
+    FileRotationPolicy rotation;                   /**< Rotation triggers and retention */
+    FileIndexPolicy indexPolicy;                   /**< Sparse index block size */
+    std::ofstream indexFile;                       /**< Index of the current segment, open if indexPolicy is enabled */
+    fmt::memory_buffer indexBuffer;                /**< Encoded entries not yet written to indexFile */
+    FileLogIndex::Entry block;                     /**< Block being filled, length 0 when empty */
+    std::atomic<std::ofstream*> nextIndex{nullptr}; /**< Pre-opened index of the next segment, published before nextSegment */
+    utils::TimestampFormatter timestampFormatter;  /**< Cached renderer for event timestamps */
+    utils::CallSiteTextCache locations;            /**< Location text rendered once per call site */
+    fmt::memory_buffer buffer;                     /**< Pending output not yet written to the file */
+    std::chrono::steady_clock::time_point lastFlush; /**< When buffer was last written out */
+    std::size_t segmentBytes{0};                   /**< Bytes written to the current segment */
+    std::string writeError;                        /**< Failure of the last write not thrown yet, empty if none */
+    std::chrono::system_clock::time_point rotateAt; /**< Next interval-based rotation, max() if disabled */
+    std::atomic<std::ofstream*> nextSegment{nullptr}; /**< Pre-opened next segment, owned by whoever holds it */
+    std::atomic<bool> prepareFailed{false};        /**< Set by the rotation thread when name.next could not be set up */
+    std::chrono::steady_clock::time_point retryAt{}; /**< Earliest next request to retry, logging thread only */
+    std::chrono::seconds retryDelay{1};            /**< Current retry backoff, logging thread only */
+    bool stallReported{false};                     /**< Whether the current stall was reported, logging thread only */
+    std::mutex rotationMutex;                      /**< Guards retiredSegments and retryRequested */
+    std::condition_variable_any rotationCV;        /**< Wakes the rotation thread */
+    std::vector<std::unique_ptr<std::ofstream>> retiredSegments; /**< Rolled segments waiting to be closed and renamed */
+    bool retryRequested{false};                    /**< Asks the rotation thread to set up name.next again */
+    std::jthread rotationThread;                   /**< Background renames and pre-opening, only with rotation enabled */
+};
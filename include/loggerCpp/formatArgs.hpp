@@ -0,0 +1,410 @@
+#pragma once
+
+#include "utils.hpp"
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace utils {
+
+    /**
+     * @brief Type tag written in front of every deferred argument
+     */
+    enum class ArgTag : uint8_t {
+        INT,            /**< Signed integer, widened to int64_t */
+        UINT,           /**< Unsigned integer, widened to uint64_t */
+        DOUBLE,         /**< double */
+        LONG_DOUBLE,    /**< long double */
+        BOOL,           /**< bool */
+        CHAR,           /**< Single char */
+        STRING,         /**< Length-prefixed copy of a string */
+        POINTER,        /**< Untyped pointer, printed as an address */
+        FIELD,          /**< Structured field: length-prefixed key, followed by the encoded value */
+        FLOAT           /**< float, kept narrow so it prints the same shortest digits as when formatted directly */
+    };
+
+    /**
+     * @brief Named value attached to a log call, see kv()
+     *
+     * Holds a reference only: it lives as long as the full expression of the log call, during
+     * which the engine either copies the value into the event or formats it.
+     */
+    template<typename T>
+    struct KeyValue {
+        std::string_view key;   /**< Field name, copied into the event */
+        const T& value;         /**< Field value */
+    };
+
+    /**
+     * @brief Attaches a structured field to a log call
+     *
+     * @code
+     * using utils::kv;
+     * LOG_INFO("order placed", kv("id", id), kv("ms", elapsed));
+     * @endcode
+     *
+     * Fields do not take part in the format string. Text sinks print them after the message as
+     * " id=42 ms=1.5"; JsonLogSink and BinaryLogSink keep them typed.
+     *
+     * @param key Field name
+     * @param value Field value, anything fmt can format
+     */
+    template<typename T>
+    [[nodiscard]] constexpr KeyValue<T> kv(std::string_view key, const T& value) noexcept {
+        return {key, value};
+    }
+
+    /**
+     * @brief Whether a (decayed) argument type is a structured field
+     */
+    template<typename T>
+    inline constexpr bool isField = false;
+
+    template<typename T>
+    inline constexpr bool isField<KeyValue<T>> = true;
+
+    /**
+     * @brief Whether any of the arguments is a structured field
+     */
+    template<typename... Args>
+    inline constexpr bool hasFieldArgs = (isField<std::decay_t<Args>> || ...);
+
+    /**
+     * @brief Scratch state reused by the logging thread to render deferred messages
+     */
+    struct FormatScratch {
+        fmt::memory_buffer buffer;                                   /**< Output buffer, keeps its capacity between events */
+        fmt::dynamic_format_arg_store<fmt::format_context> store;    /**< Decoded arguments referencing the event's storage */
+    };
+
+    /**
+     * @brief Whether a (decayed) argument type can be captured by value for deferred formatting
+     *
+     * Anything not listed here (user types with custom formatters, enums, wide strings, ...)
+     * is formatted on the caller's thread instead.
+     */
+    template<typename T>
+    inline constexpr bool isDeferrableArg =
+        std::is_same_v<T, bool> || std::is_same_v<T, char> ||
+        (std::is_integral_v<T> && !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> &&
+         !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>) ||
+        std::is_floating_point_v<T> ||
+        std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+        std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+        std::is_same_v<T, void*> || std::is_same_v<T, const void*> || std::is_same_v<T, std::nullptr_t>;
+
+    /**
+     * @brief A field is captured when its value is
+     */
+    template<typename T>
+    inline constexpr bool isDeferrableArg<KeyValue<T>> = isDeferrableArg<std::decay_t<T>>;
+
+    namespace detail {
+
+        template<typename T>
+        std::byte* put(std::byte* out, const T& value) noexcept {
+            std::memcpy(out, &value, sizeof(T));
+            return out + sizeof(T);
+        }
+
+        template<typename T>
+        [[nodiscard]] std::string_view asString(const T& value) noexcept {
+            if constexpr (std::is_pointer_v<T>) {
+                return value ? std::string_view(value) : std::string_view();
+            } else {
+                return std::string_view(value);
+            }
+        }
+
+        /**
+         * @brief Number of bytes needed to encode one argument, tag included
+         */
+        template<typename T>
+        [[nodiscard]] std::size_t encodedSize(const T& value) noexcept {
+            if constexpr (isField<T>) {
+                return 1 + sizeof(uint32_t) + value.key.size() + encodedSize(value.value);
+            } else if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+                return 1 + sizeof(T);
+            } else if constexpr (std::is_integral_v<T>) {
+                return 1 + sizeof(uint64_t);
+            } else if constexpr (std::is_same_v<T, long double>) {
+                return 1 + sizeof(long double);
+            } else if constexpr (std::is_same_v<T, float>) {
+                return 1 + sizeof(float);
+            } else if constexpr (std::is_floating_point_v<T>) {
+                return 1 + sizeof(double);
+            } else if constexpr (std::is_same_v<T, void*> || std::is_same_v<T, const void*> || std::is_same_v<T, std::nullptr_t>) {
+                return 1 + sizeof(const void*);
+            } else {
+                return 1 + sizeof(uint32_t) + asString(value).size();
+            }
+        }
+
+        /**
+         * @brief Encodes one argument at @p out and returns the position past it
+         */
+        template<typename T>
+        std::byte* encode(std::byte* out, const T& value) noexcept {
+            if constexpr (std::is_same_v<T, bool>) {
+                *out++ = std::byte(ArgTag::BOOL);
+                return put(out, value);
+            } else if constexpr (std::is_same_v<T, char>) {
+                *out++ = std::byte(ArgTag::CHAR);
+                return put(out, value);
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                *out++ = std::byte(ArgTag::INT);
+                return put(out, static_cast<int64_t>(value));
+            } else if constexpr (std::is_integral_v<T>) {
+                *out++ = std::byte(ArgTag::UINT);
+                return put(out, static_cast<uint64_t>(value));
+            } else if constexpr (std::is_same_v<T, long double>) {
+                *out++ = std::byte(ArgTag::LONG_DOUBLE);
+                return put(out, value);
+            } else if constexpr (std::is_same_v<T, float>) {
+                *out++ = std::byte(ArgTag::FLOAT);
+                return put(out, value);
+            } else if constexpr (std::is_floating_point_v<T>) {
+                *out++ = std::byte(ArgTag::DOUBLE);
+                return put(out, static_cast<double>(value));
+            } else if constexpr (std::is_same_v<T, void*> || std::is_same_v<T, const void*> || std::is_same_v<T, std::nullptr_t>) {
+                *out++ = std::byte(ArgTag::POINTER);
+                return put(out, static_cast<const void*>(value));
+            } else {
+                const std::string_view text = asString(value);
+                *out++ = std::byte(ArgTag::STRING);
+                out = put(out, static_cast<uint32_t>(text.size()));
+                std::memcpy(out, text.data(), text.size());
+                return out + text.size();
+            }
+        }
+
+        /**
+         * @brief Encodes a positional argument; fields are skipped
+         */
+        template<typename T>
+        std::byte* encodePositional(std::byte* out, const T& value) noexcept {
+            if constexpr (isField<T>) {
+                return out;
+            } else {
+                return encode(out, value);
+            }
+        }
+
+        /**
+         * @brief Encodes a field as its key followed by its value; positional arguments are skipped
+         */
+        template<typename T>
+        std::byte* encodeField(std::byte* out, const T& field) noexcept {
+            if constexpr (isField<T>) {
+                *out++ = std::byte(ArgTag::FIELD);
+                out = put(out, static_cast<uint32_t>(field.key.size()));
+                std::memcpy(out, field.key.data(), field.key.size());
+                return encode(out + field.key.size(), field.value);
+            } else {
+                return out;
+            }
+        }
+
+        template<typename T>
+        const std::byte* get(const std::byte* in, T& value) noexcept {
+            std::memcpy(&value, in, sizeof(T));
+            return in + sizeof(T);
+        }
+
+        [[nodiscard]] inline std::string_view getString(const std::byte*& in) noexcept {
+            uint32_t size;
+            in = get(in, size);
+            const std::string_view text(reinterpret_cast<const char*>(in), size);
+            in += size;
+            return text;
+        }
+
+        /**
+         * @brief Decodes the value at @p in, whose tag has been read, and returns the position past it
+         */
+        template<typename Visitor>
+        const std::byte* decodeValue(ArgTag tag, const std::byte* in, Visitor&& visit) {
+            switch (tag) {
+                case ArgTag::INT: { int64_t v; in = get(in, v); visit(v); break; }
+                case ArgTag::UINT: { uint64_t v; in = get(in, v); visit(v); break; }
+                case ArgTag::FLOAT: { float v; in = get(in, v); visit(v); break; }
+                case ArgTag::DOUBLE: { double v; in = get(in, v); visit(v); break; }
+                case ArgTag::LONG_DOUBLE: { long double v; in = get(in, v); visit(v); break; }
+                case ArgTag::BOOL: { bool v; in = get(in, v); visit(v); break; }
+                case ArgTag::CHAR: { char v; in = get(in, v); visit(v); break; }
+                case ArgTag::POINTER: { const void* v; in = get(in, v); visit(v); break; }
+                case ArgTag::STRING: visit(getString(in)); break;
+                case ArgTag::FIELD: break;
+            }
+            return in;
+        }
+
+        template<typename T>
+        [[nodiscard]] auto positional(const T& value) noexcept {
+            if constexpr (isField<T>) {
+                return std::tuple<>();
+            } else {
+                return std::tuple<const T&>(value);
+            }
+        }
+
+        template<typename T>
+        void appendFieldText(fmt::memory_buffer& out, const T& field) {
+            if constexpr (isField<T>) {
+                fmt::format_to(fmt::appender(out), " {}={}", field.key, field.value);
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Calls @p visit with every positional argument of an encoded payload, in order
+     *
+     * Integers arrive widened to int64_t / uint64_t, floating point as float, double or long
+     * double, strings as a std::string_view into @p encoded. Fields are encoded after all
+     * positional arguments and are not visited, see visitFields().
+     *
+     * @param encoded Encoded arguments, as returned by LogEvent::args()
+     * @param visit Callable accepting each of the decoded value types
+     */
+    template<typename Visitor>
+    void visitArgs(std::string_view encoded, Visitor&& visit) {
+        const auto* in = reinterpret_cast<const std::byte*>(encoded.data());
+        const std::byte* end = in + encoded.size();
+
+        while (in < end) {
+            const auto tag = static_cast<ArgTag>(*in++);
+            if (tag == ArgTag::FIELD) return;
+            in = detail::decodeValue(tag, in, visit);
+        }
+    }
+
+    /**
+     * @brief Calls @p visit with the key and value of every field of an encoded payload, in order
+     *
+     * Values arrive as in visitArgs().
+     *
+     * @param encoded Encoded arguments, as returned by LogEvent::args()
+     * @param visit Callable accepting (std::string_view key, value) for each of the value types
+     */
+    template<typename Visitor>
+    void visitFields(std::string_view encoded, Visitor&& visit) {
+        const auto* in = reinterpret_cast<const std::byte*>(encoded.data());
+        const std::byte* end = in + encoded.size();
+
+        while (in < end) {
+            const auto tag = static_cast<ArgTag>(*in++);
+            if (tag != ArgTag::FIELD) {
+                in = detail::decodeValue(tag, in, [](const auto&) {});
+                continue;
+            }
+            const std::string_view key = detail::getString(in);
+            const auto valueTag = static_cast<ArgTag>(*in++);
+            in = detail::decodeValue(valueTag, in, [&](const auto& value) { visit(key, value); });
+        }
+    }
+
+    /**
+     * @brief Whether an encoded payload carries fields
+     * @param encoded Encoded arguments, as returned by LogEvent::args()
+     */
+    [[nodiscard]] bool hasFields(std::string_view encoded) noexcept;
+
+    /**
+     * @brief Largest encoded argument payload captured for deferred formatting
+     */
+    inline constexpr std::size_t MAX_DEFERRED_ARGS_SIZE = BufferPool::BLOCK_SIZE;
+
+    /**
+     * @brief Captures format arguments into the event's payload and marks it deferred
+     *
+     * Only copies bytes; no formatting happens on the caller's thread. Strings are copied
+     * so the event does not depend on the caller's buffers. Payloads larger than the inline
+     * storage borrow a pooled block. Fields are encoded after the positional arguments,
+     * whatever their order in the call.
+     *
+     * @param event Event receiving the encoded arguments
+     * @param args Arguments, every type must satisfy isDeferrableArg
+     * @return false if the arguments do not fit, in which case the caller should format eagerly
+     */
+    template<typename... Args>
+    [[nodiscard]] bool encodeArgs(LogEvent& event, const Args&... args) noexcept {
+        const std::size_t size = (std::size_t{0} + ... + detail::encodedSize(args));
+        if (size > MAX_DEFERRED_ARGS_SIZE) [[unlikely]] return false;
+
+        char* storage = event.reserveArgs(size);
+        if (storage == nullptr) [[unlikely]] return false;
+
+        [[maybe_unused]] std::byte* out = reinterpret_cast<std::byte*>(storage);
+        ((out = detail::encodePositional(out, args)), ...);
+        ((out = detail::encodeField(out, args)), ...);
+        return true;
+    }
+
+    namespace detail {
+        template<typename Tuple>
+        struct FormatStringOf;
+
+        template<typename... Ts>
+        struct FormatStringOf<std::tuple<Ts...>> {
+            using type = fmt::format_string<Ts...>;
+        };
+    } // namespace detail
+
+    /**
+     * @brief fmt::format_string for the positional arguments of a log call, fields left out
+     *
+     * Constructing one from a constant string checks it against the argument types at
+     * compile time.
+     */
+    template<typename... Args>
+    using PositionalFormatString =
+        typename detail::FormatStringOf<decltype(std::tuple_cat(detail::positional(std::declval<const std::decay_t<Args>&>())...))>::type;
+
+    /**
+     * @brief Formats arguments eagerly, printing fields after the message like renderDeferred()
+     *
+     * @param out Buffer to append to
+     * @param format Format string, compiled or not, consuming the positional arguments only
+     * @param args Arguments, fields in any position
+     * @throws fmt::format_error on a bad format string or argument
+     */
+    template<typename Format, typename... Args>
+    void formatWithFields(fmt::memory_buffer& out, const Format& format, const Args&... args) {
+        std::apply([&](const auto&... values) {
+            formatTo(out, format, values...);
+        }, std::tuple_cat(detail::positional(args)...));
+        (detail::appendFieldText(out, args), ...);
+    }
+
+    /**
+     * @brief Formats the format string of a deferred event with its positional arguments
+     *
+     * Fields are left out. Format errors are reported inside the text rather than thrown.
+     *
+     * @param event Event with a format string and encoded arguments
+     * @param scratch Reusable buffers owned by the calling thread; the text is left in scratch.buffer
+     * @return View of the text in scratch.buffer
+     */
+    std::string_view formatDeferred(const LogEvent& event, FormatScratch& scratch) noexcept;
+
+    /**
+     * @brief Formats a deferred event into its message
+     *
+     * The encoded arguments and the format string are kept, so sinks that store them instead
+     * of the text still can. Fields are printed after the message as " key=value". Format errors
+     * are reported inside the message rather than thrown.
+     *
+     * @param event Event whose format string and encoded arguments should be rendered
+     * @param scratch Reusable buffers owned by the calling thread
+     */
+    void renderDeferred(LogEvent& event, FormatScratch& scratch) noexcept;
+
+} // namespace utils
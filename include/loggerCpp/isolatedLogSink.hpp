@@ -0,0 +1,127 @@
+#pragma once
+
+#include "logSink.hpp"
+#include "ringBuffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Queue sizing of an IsolatedLogSink
+ */
+struct IsolatedSinkOptions {
+    std::size_t capacity = 8192;    /**< Events buffered for the wrapped sink before new ones are dropped */
+    std::size_t batchSize = 256;    /**< Events handed to the wrapped sink per writeBatch() call */
+};
+
+/**
+ * @brief Counters describing how far an IsolatedLogSink is behind
+ */
+struct SinkStats {
+    uint64_t enqueued{0};               /**< Events accepted from the logging thread */
+    uint64_t written{0};                /**< Events written by the wrapped sink */
+    uint64_t failed{0};                 /**< Events of writeBatch() calls of the wrapped sink that threw */
+    uint64_t errors{0};                 /**< writeBatch() and flush() calls of the wrapped sink that threw */
+    uint64_t dropped{0};                /**< Events discarded because the queue was full */
+    std::size_t backlog{0};             /**< Events waiting in the queue */
+    std::chrono::nanoseconds lag{0};    /**< Newest accepted minus newest written event timestamp */
+};
+
+/**
+ * @brief Runs another sink on its own queue and worker thread
+ *
+ * The logging thread only copies events into this sink's bounded ring, so a sink that blocks
+ * (a full pipe, a slow syslog daemon) delays nothing but its own queue. When that queue is
+ * full, new events for this sink are dropped and counted instead of stalling the other sinks.
+ * A wrapped sink that throws loses that batch, counted in SinkStats::failed; the worker keeps
+ * draining.
+ *
+ * @code
+ * engine.addSink(std::make_shared<IsolatedLogSink>(std::make_shared<SysLogSink>("app")), utils::LogLevel::ERROR);
+ * @endcode
+ */
+class IsolatedLogSink final : public LogSink {
+public:
+    /**
+     * @brief Wraps a sink and starts its worker thread
+     *
+     * @param sink The sink to run in isolation
+     * @param options Queue sizing
+     */
+    explicit IsolatedLogSink(std::shared_ptr<LogSink> sink, const IsolatedSinkOptions& options = {});
+
+    /**
+     * @brief Writes out the remaining backlog and stops the worker thread
+     */
+    ~IsolatedLogSink() noexcept override;
+
+    /**
+     * @brief Queues a log event for the wrapped sink
+     *
+     * @param event The log event to be written
+     */
+    void write(const utils::LogEvent& event) override;
+
+    /**
+     * @brief Queues a batch of log events for the wrapped sink
+     *
+     * @param events The events to be written, in order
+     */
+    void writeBatch(std::span<const utils::LogEvent> events) override;
+
+    /**
+     * @brief Asks the worker to flush the wrapped sink once the events queued so far are written
+     */
+    void flush() override;
+
+    /**
+     * @brief Current queue counters, safe to call from any thread
+     */
+    [[nodiscard]] SinkStats stats() const noexcept;
+
+private:
+    /**
+     * @brief Body of the worker thread
+     * @param stop Stop token of the thread
+     */
+    void workerLoop(std::stop_token stop) noexcept;
+
+    /**
+     * @brief Writes up to batchSize queued events to the wrapped sink
+     * @return Number of events taken from the queue, written or failed
+     */
+    std::size_t drainBatch() noexcept;
+
+    /**
+     * @brief Flushes the wrapped sink, counting an exception as an error
+     */
+    void flushSink() noexcept;
+
+    /**
+     * @brief Wakes the worker if it is parked
+     */
+    void wakeWorker() noexcept;
+
+    static constexpr std::chrono::milliseconds IDLE_TIMEOUT{100};   /**< Longest the worker parks without a wakeup */
+
+    std::shared_ptr<LogSink> sink;                          /**< Wrapped sink, only touched by the worker */
+    IsolatedSinkOptions options;                            /**< Queue sizing */
+    alignas(64) RingBuffer<utils::LogEvent> queue;          /**< Events waiting for the wrapped sink */
+    std::vector<utils::LogEvent> batch;                     /**< Events being written, worker only */
+    alignas(64) std::atomic<bool> workerSleeping{false};    /**< Set while the worker is parked */
+    std::binary_semaphore queueSem{0};                      /**< Wakes the worker */
+    std::atomic<bool> flushRequested{false};                /**< Set by flush(), cleared by the worker */
+    alignas(64) std::atomic<uint64_t> enqueued{0};          /**< See SinkStats::enqueued */
+    std::atomic<uint64_t> dropped{0};                       /**< See SinkStats::dropped */
+    std::atomic<uint64_t> newestEnqueued{0};                /**< Timestamp of the newest accepted event */
+    alignas(64) std::atomic<uint64_t> written{0};           /**< See SinkStats::written */
+    std::atomic<uint64_t> newestWritten{0};                 /**< Timestamp of the newest written event */
+    std::atomic<uint64_t> failed{0};                        /**< See SinkStats::failed */
+    std::atomic<uint64_t> errors{0};                        /**< See SinkStats::errors */
+    std::jthread worker;                                    /**< Thread running the wrapped sink */
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <string_view>
+
+namespace utils {
+
+    /**
+     * @brief Appends text as the body of a JSON string, without the surrounding quotes
+     *
+     * Quotes, backslashes and control characters are escaped; every other byte, UTF-8
+     * sequences included, is copied as is. Runs of clean bytes are found 16 or 32 at a time
+     * (SSE2, or AVX2 when the CPU has it) and copied in one append.
+     *
+     * @param out Buffer to append to
+     * @param text Text to escape
+     */
+    void appendJsonEscaped(fmt::memory_buffer& out, std::string_view text);
+
+    /**
+     * @brief Appends text for a terminal, neutralizing control characters
+     *
+     * Control characters other than newline and tab, and DEL, are written as "\xNN", so a
+     * message cannot move the cursor, recolor or retitle the terminal through ANSI escapes.
+     * Scanned like appendJsonEscaped().
+     *
+     * @param out Buffer to append to
+     * @param text Text to sanitize
+     */
+    void appendSanitized(fmt::memory_buffer& out, std::string_view text);
+
+} // namespace utils
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "logSink.hpp"
+#include "fileLogSink.hpp"
+#include "formatArgs.hpp"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string_view>
+
+/**
+ * @brief JSON lines file sink
+ *
+ * Writes one JSON object per event:
+ *
+ * @code
+ * {"timestamp":"2024-01-31T12:34:56.789012Z","level":"INFO","file":"main.cpp","line":42,
+ *  "function":"int main()","message":"order placed","fields":{"id":42,"ms":1.5}}
+ * @endcode
+ *
+ * "fields" holds the utils::kv() fields of the call, typed: integers, floats and booleans as
+ * JSON numbers and literals, everything else as strings; it is left out for events without
+ * fields. Fields whose value could not be captured (see utils::isDeferrableArg) only appear
+ * in the message text. Records are serialized into a buffer that keeps its capacity, so
+ * steady-state writes do not allocate; the buffer goes to the file under a FileFlushPolicy.
+ */
+class JsonLogSink final : public LogSink {
+public:
+    /**
+     * @brief Constructs a JsonLogSink appending to the given file
+     *
+     * @param fileName The name/path of the file to write to
+     * @param policy When buffered output is written to the file
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    explicit JsonLogSink(std::string_view fileName, const FileFlushPolicy& policy = {});
+
+    /**
+     * @brief Writes out buffered records before closing the file
+     */
+    ~JsonLogSink() noexcept override;
+
+    /**
+     * @brief Writes a log event to the file
+     *
+     * @param event The log event to be written
+     */
+    void write(const utils::LogEvent& event) override;
+
+    /**
+     * @brief Serializes a batch of log events, writing the buffer once a trigger of the policy fires
+     *
+     * @param events The events to be written, in order
+     */
+    void writeBatch(std::span<const utils::LogEvent> events) override;
+
+    /**
+     * @brief Writes buffered records to the file
+     */
+    void flush() override;
+
+private:
+    /**
+     * @brief Appends the JSON record of one event to the buffer
+     * @param event The event to serialize
+     */
+    void appendEvent(const utils::LogEvent& event);
+
+    /**
+     * @brief Appends the fields of an encoded payload as the members of a JSON object
+     * @param encoded Encoded arguments, as returned by LogEvent::args()
+     */
+    void appendFields(std::string_view encoded);
+
+    /**
+     * @brief RFC 3339 UTC time with microseconds, e.g. "2024-01-31T12:34:56.789012Z"
+     * @param timestamp Nanoseconds since the Unix epoch
+     * @return View into timestampText, valid until the next call
+     */
+    std::string_view formatTimestamp(uint64_t timestamp) noexcept;
+
+    /**
+     * @brief Writes the buffer to the file with a single call
+     */
+    void writeBuffer();
+
+    std::ofstream file;                                 /**< Output file */
+    FileFlushPolicy policy;                             /**< When the buffer is written out */
+    std::chrono::steady_clock::time_point lastFlush;    /**< Time of the last write */
+    fmt::memory_buffer buffer;                          /**< Serialized records waiting to be written */
+    utils::CallSiteTextCache locations;                 /**< Escaped "file", "line" and "function" values by call site */
+    utils::FormatScratch scratch;                       /**< Renders the message of events with fields */
+    int64_t cachedSecond{-1};                           /**< Second the timestamp prefix was built for */
+    char timestampText[32]{};                           /**< "YYYY-MM-DDTHH:MM:SS" prefix, then fraction and "Z" */
+};
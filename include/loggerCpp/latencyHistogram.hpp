@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace utils {
+
+    /**
+     * @brief Distribution of durations in power-of-two nanosecond buckets
+     *
+     * Bucket i holds durations in [2^(i-1), 2^i) ns, bucket 0 holds zero. Percentiles are
+     * therefore reported as the upper bound of a bucket, at most twice the true value.
+     */
+    struct LatencyHistogram {
+        static constexpr std::size_t BUCKETS = 40;  /**< The last bucket also takes everything above ~4.5 minutes */
+
+        std::array<uint64_t, BUCKETS> buckets{};    /**< Samples per bucket */
+        uint64_t count{0};                          /**< Number of samples */
+        uint64_t totalNs{0};                        /**< Sum of all samples */
+        uint64_t maxNs{0};                          /**< Largest sample */
+
+        /**
+         * @brief Bucket a duration falls into
+         * @param ns Duration in nanoseconds
+         */
+        [[nodiscard]] static constexpr std::size_t bucketOf(uint64_t ns) noexcept {
+            return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(ns)), BUCKETS - 1);
+        }
+
+        /**
+         * @brief Approximate percentile
+         * @param p Fraction between 0 and 1, e.g. 0.99
+         * @return Upper bound of the bucket holding the percentile, capped at maxNs; 0 without samples
+         */
+        [[nodiscard]] uint64_t percentile(double p) const noexcept;
+
+        /**
+         * @brief Mean duration, 0 without samples
+         */
+        [[nodiscard]] uint64_t meanNs() const noexcept {
+            return count == 0 ? 0 : totalNs / count;
+        }
+
+        /**
+         * @brief Adds the samples of another histogram to this one
+         * @param other Histogram to add
+         */
+        void merge(const LatencyHistogram& other) noexcept;
+    };
+
+    /**
+     * @brief LatencyHistogram that can be recorded into from several threads
+     *
+     * Every field is a relaxed atomic, so a reader may see a sample in a bucket before it
+     * shows up in count. Give each writing thread its own instance where contention matters.
+     */
+    struct AtomicLatencyHistogram {
+        std::array<std::atomic<uint64_t>, LatencyHistogram::BUCKETS> buckets{};   /**< See LatencyHistogram::buckets */
+        std::atomic<uint64_t> count{0};                                         /**< See LatencyHistogram::count */
+        std::atomic<uint64_t> totalNs{0};                                       /**< See LatencyHistogram::totalNs */
+        std::atomic<uint64_t> maxNs{0};                                         /**< See LatencyHistogram::maxNs */
+
+        /**
+         * @brief Records one duration
+         * @param ns Duration in nanoseconds
+         */
+        void record(uint64_t ns) noexcept {
+            buckets[LatencyHistogram::bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+            totalNs.fetch_add(ns, std::memory_order_relaxed);
+            uint64_t max = maxNs.load(std::memory_order_relaxed);
+            while (ns > max && !maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+        }
+
+        /**
+         * @brief Adds the current samples to a plain histogram
+         * @param into Histogram receiving the samples
+         */
+        void addTo(LatencyHistogram& into) const noexcept;
+    };
+
+} // namespace utils
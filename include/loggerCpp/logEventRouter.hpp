@@ -1,25 +1,79 @@
 #pragma once
 
 #include "utils.hpp"
-#include <unordered_map>
+#include "latencyHistogram.hpp"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
+#include <span>
 
 class LogSink;
 
+namespace utils {
+
+    /**
+     * @brief Set of log levels, one bit per LogLevel value
+     */
+    using LevelMask = uint8_t;
+
+    /**
+     * @brief Mask holding only the given level
+     */
+    [[nodiscard]] constexpr LevelMask levelBit(LogLevel level) noexcept {
+        return static_cast<LevelMask>(1u << static_cast<uint8_t>(level));
+    }
+
+    /**
+     * @brief Mask holding the given level and every level above it, NONE excluded
+     */
+    [[nodiscard]] constexpr LevelMask levelsFrom(LogLevel minLevel) noexcept {
+        return static_cast<LevelMask>(levelBit(LogLevel::NONE) - levelBit(minLevel));
+    }
+
+} // namespace utils
+
+/**
+ * @brief A sink and the levels routed to it, see LogEventRouter::replaceRoutes()
+ */
+struct SinkRoute {
+    utils::LevelMask levels{0};                 /**< Levels routed to the sink */
+    std::shared_ptr<LogSink> sink;              /**< The sink */
+};
+
+/**
+ * @brief Write statistics of one subscribed sink
+ */
+struct SinkMetrics {
+    std::shared_ptr<LogSink> sink;              /**< The sink, as passed to addRoute() */
+    utils::LevelMask levels{0};                 /**< Levels routed to the sink */
+    uint64_t events{0};                         /**< Events handed to the sink */
+    uint64_t errors{0};                         /**< writeBatch() and flush() calls that threw */
+    utils::LatencyHistogram writeTime;          /**< Duration of each writeBatch() call */
+};
+
 /**
  * @brief Routes log events to appropriate sinks based on log level
  *
- * This class manages the routing of log events to registered logging sinks based on
- * their configured log levels. It provides thread-safe routing capabilities and
- * efficient cache-aligned data structures. Supports multiple sinks per log level.
+ * Each sink subscribes with a level mask (levelsFrom() for a minimum level). The routing table
+ * is the list of subscriptions, published as an immutable snapshot: addRoute() builds a new
+ * table and swaps it in atomically, so routing never waits for a table being modified. A
+ * batch holds on to the snapshot it started with.
+ *
+ * Every sink gets at most one writeBatch() call per batch, holding the events of its levels in
+ * order; that call is timed and its events counted. A sink that throws is
+ * counted as an error and skipped for that batch; the other sinks still get the events.
+ *
+ * Calls into the sinks are serialized: in sync mode every producer thread routes, and sinks
+ * keep their buffers and caches in members, so routeBatch(), flush() and writeTo() hold one
+ * mutex while they call them. The logging thread alone never contends for it.
  */
 class LogEventRouter {
 public:
     /**
      * @brief Default constructor
      */
-    LogEventRouter() noexcept = default;
+    LogEventRouter();
 
     /**
      * @brief Default destructor
@@ -37,21 +91,42 @@ public:
     LogEventRouter& operator=(const LogEventRouter&) = delete;
 
     /**
-     * @brief Move constructor for efficient resource transfer
+     * @brief Deleted move constructor, the published snapshot is not movable
      */
-    LogEventRouter(LogEventRouter&&) noexcept = default;
+    LogEventRouter(LogEventRouter&&) = delete;
 
     /**
-     * @brief Move assignment operator for efficient resource transfer
+     * @brief Deleted move assignment operator, the published snapshot is not movable
      */
-    LogEventRouter& operator=(LogEventRouter&&) noexcept = default;
+    LogEventRouter& operator=(LogEventRouter&&) = delete;
 
     /**
-     * @brief Adds a new route mapping between a log level and sink
-     * @param level The log level to route
+     * @brief Subscribes a sink to a set of levels
+     *
+     * Safe to call while events are being routed; takes effect from the next batch.
+     *
+     * @param levels Levels routed to the sink, e.g. utils::levelsFrom(utils::LogLevel::INFO)
      * @param sink The sink to route messages to
      */
-    void addRoute(utils::LogLevel level, std::shared_ptr<LogSink> sink) noexcept;
+    void addRoute(utils::LevelMask levels, std::shared_ptr<LogSink> sink);
+
+    /**
+     * @brief Replaces every subscription with a new set, in one swap
+     *
+     * The whole table is built before it is published, so a batch is routed either entirely
+     * with the old routes or entirely with the new ones. Sinks that stay subscribed keep their
+     * counters.
+     *
+     * @param routes The new subscriptions, in order
+     */
+    void replaceRoutes(std::vector<SinkRoute> routes);
+
+    /**
+     * @brief Unsubscribes every sink
+     *
+     * Sinks are released once the logging thread is done with the batch it is routing.
+     */
+    void clearRoutes();
 
     /**
      * @brief Sets the current global log level
@@ -65,7 +140,64 @@ public:
      */
     void routeEvent(const utils::LogEvent& event) noexcept;
 
+    /**
+     * @brief Routes a batch of log events, in order
+     *
+     * Each sink gets the events of its levels as one writeBatch() call, in their original
+     * order: the batch itself when it takes every level present, the run between its first and
+     * last event when nothing in between is filtered out, and a filtered copy otherwise.
+     *
+     * @param events The log events to route
+     */
+    void routeBatch(std::span<const utils::LogEvent> events) noexcept;
+
+    /**
+     * @brief Asks every registered sink to flush its buffered output
+     */
+    void flush() noexcept;
+
+    /**
+     * @brief Writes one event to a sink that need not be subscribed, serialized with routing
+     * @param sink The sink
+     * @param event The event
+     * @throws whatever the sink's write() throws
+     */
+    void writeTo(LogSink& sink, const utils::LogEvent& event);
+
+    /**
+     * @brief Write statistics of the currently subscribed sinks, in subscription order
+     */
+    [[nodiscard]] std::vector<SinkMetrics> sinkMetrics() const;
+
 private:
-    alignas(64) std::unordered_map<utils::LogLevel, std::vector<std::shared_ptr<LogSink>>> routes; /**< Cache-aligned routing map supporting multiple sinks per level */
-    alignas(64) utils::LogLevel currentLogLevel{utils::LogLevel::INFO}; /**< Cache-aligned current log level */
-};
\ No newline at end of file
+    /**
+     * @brief Counters of one subscription, updated by whichever thread routes
+     */
+    struct SinkCounters {
+        std::atomic<uint64_t> events{0};            /**< See SinkMetrics::events */
+        std::atomic<uint64_t> errors{0};            /**< See SinkMetrics::errors */
+        utils::AtomicLatencyHistogram writeTime;    /**< See SinkMetrics::writeTime */
+    };
+
+    /**
+     * @brief A sink, the levels it subscribed to and its counters
+     */
+    struct Subscription {
+        std::shared_ptr<LogSink> sink;              /**< Owning reference to the sink */
+        utils::LevelMask levels;                    /**< Levels routed to the sink */
+        std::shared_ptr<SinkCounters> counters;     /**< Shared with the routes built from this subscription */
+    };
+
+    /**
+     * @brief Immutable routing table
+     */
+    struct Snapshot {
+        std::vector<Subscription> subscriptions;                                /**< Sinks and their levels, in subscription order */
+    };
+
+    alignas(64) std::atomic<std::shared_ptr<const Snapshot>> snapshot; /**< Current routing table */
+    alignas(64) std::atomic<utils::LogLevel> currentLogLevel{utils::LogLevel::INFO}; /**< Cache-aligned current log level */
+    std::mutex updateMutex; /**< Serialises writers building a new snapshot */
+    std::mutex writeMutex; /**< Serialises calls into the sinks */
+    std::vector<utils::LogEvent> filtered; /**< Events of a batch taken by one sink, guarded by writeMutex */
+};
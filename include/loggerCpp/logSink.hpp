@@ -5,12 +5,16 @@
 #include <source_location>
 #include <fstream>
 #include <string_view>
+#include <span>
 
 /**
  * @brief Abstract base class for log sinks
  *
  * This class defines the interface for all logging sinks. A sink represents a destination
  * where log messages can be written, such as console, file, network, or database.
+ *
+ * The engine never calls into a sink from two threads at once (see LogEventRouter), so
+ * implementations may keep per-call buffers in members without locking them.
  */
 class LogSink {
 public:
@@ -25,6 +29,28 @@ public:
      */
     virtual void write(const utils::LogEvent& event) = 0;
 
+    /**
+     * @brief Write a batch of consecutive log events
+     *
+     * The logging thread hands sinks whole runs of events at once. The default forwards each
+     * event to write(); sinks that can emit a batch with a single system call override it.
+     *
+     * @param events The events to be written, in order
+     */
+    virtual void writeBatch(std::span<const utils::LogEvent> events) {
+        for (const auto& event : events) {
+            write(event);
+        }
+    }
+
+    /**
+     * @brief Flush any output the sink keeps buffered
+     *
+     * Called by the logging thread when the queue has been idle for a while and on shutdown.
+     * The default does nothing, for sinks that write through immediately.
+     */
+    virtual void flush() {}
+
 protected:
     /**
      * @brief Protected default constructor
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "loggingEngine.hpp"
+
+#include <atomic>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Logs through a named logger, e.g. LOG_TO(http, DEBUG, "GET {}", path)
+ *
+ * Same expansion as LOG_*, but the runtime test is the logger's cached effective level
+ * instead of the global one. @p logger is evaluated once, before the level test; keep the
+ * handle (static Logger& http = Logger::get("net.http");) rather than looking it up per call.
+ */
+#define LOG_TO(logger, level, msg, ...) \
+    do { \
+        if constexpr (utils::LogLevel::level >= utils::ACTIVE_LEVEL) { \
+            const Logger& loggerCppLogger = (logger); \
+            if (loggerCppLogger.isEnabled(utils::LogLevel::level)) [[unlikely]] { \
+                LOGGERCPP_CALL_SITE(utils::LogLevel::level, msg); \
+                loggerCppLogger.log(loggerCppSite, LOGGERCPP_FORMAT(msg), ##__VA_ARGS__); \
+            } \
+        } \
+    } while (false)
+
+/**
+ * @class Logger
+ * @brief Named logger handle with an inherited level, e.g. "net.http" under "net"
+ *
+ * Loggers form a tree by dot-separated name; the root, named "", is the engine's global level
+ * (LoggingEngine::setLogLevel()). A logger without a level of its own takes its parent's.
+ * The resulting effective level is cached in an atomic on the handle, so the disabled check
+ * is a single relaxed load. Setting a level recomputes the cached levels of the subtree in one
+ * pass, skipping the branches that set their own.
+ *
+ * Handles live until the process exits and are safe to use from any thread. All loggers
+ * share the engine's sinks; the logger only decides which calls reach them.
+ */
+class Logger {
+public:
+    /**
+     * @brief The logger of a name, created with its missing ancestors on first use
+     *
+     * Takes a lock; look a logger up once and keep the reference.
+     *
+     * @param name Dot-separated name, "" for the root
+     * @throws std::invalid_argument if the name has an empty component ("net..http", ".net")
+     */
+    [[nodiscard]] static Logger& get(std::string_view name);
+
+    /**
+     * @brief The root logger, whose level is the engine's global level
+     */
+    [[nodiscard]] static Logger& root() noexcept;
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Full dot-separated name
+     */
+    [[nodiscard]] const std::string& name() const noexcept { return fullName; }
+
+    /**
+     * @brief Parent logger, nullptr for the root
+     */
+    [[nodiscard]] Logger* parent() const noexcept { return parentLogger; }
+
+    /**
+     * @brief Check whether a level passes the logger's effective level
+     *
+     * A single relaxed atomic load, cheap enough to run before any argument is evaluated.
+     *
+     * @param level The log level to test
+     */
+    [[nodiscard]] bool isEnabled(utils::LogLevel level) const noexcept {
+        return level >= effectiveLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Effective level: the logger's own, else the nearest ancestor's
+     */
+    [[nodiscard]] utils::LogLevel level() const noexcept {
+        return effectiveLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Level set on this logger, std::nullopt if it inherits
+     */
+    [[nodiscard]] std::optional<utils::LogLevel> assignedLevel() const;
+
+    /**
+     * @brief Set the logger's own level, which its descendants without one inherit
+     *
+     * On the root this is LoggingEngine::setLogLevel().
+     *
+     * @param level The log level to set, NONE to silence the subtree
+     */
+    void setLevel(utils::LogLevel level);
+
+    /**
+     * @brief Drop the logger's own level and inherit its parent's again
+     *
+     * The root always has a level; this does nothing on it.
+     */
+    void resetLevel();
+
+    /**
+     * @brief Log a message with a format string known at compile time, see LoggingEngine::log()
+     *
+     * The caller has checked isEnabled(site.level); LOG_TO does.
+     *
+     * @param site Static description of the call
+     * @param fmt The format string, see LOGGERCPP_FORMAT
+     * @param args Arguments to format into the message, fields in any position
+     */
+    template<utils::FixedString Format, typename... Args>
+    void log(const utils::CallSite& site, utils::CompiledFormat<Format> fmt, Args&&... args) const noexcept {
+        [[maybe_unused]] constexpr utils::PositionalFormatString<Args...> checked(Format.view());
+        LoggingEngine::getInstance().logFormatted(site, fmt, args...);
+    }
+
+    /**
+     * @brief Log a message with a format string known only at run time, see LoggingEngine::log()
+     *
+     * The caller has checked isEnabled(site.level).
+     *
+     * @param site Static description of the call
+     * @param fmt Format string
+     * @param args Arguments to format into the message, fields in any position
+     */
+    template<typename... Args>
+    void log(const utils::CallSite& site, fmt::string_view fmt, Args&&... args) const noexcept {
+        LoggingEngine::getInstance().logFormatted(site, fmt, args...);
+    }
+
+private:
+    friend class LoggingEngine;
+
+    /**
+     * @brief Constructs a logger inheriting from its parent, with the registry lock held
+     */
+    Logger(std::string name, Logger* parent) noexcept;
+
+    /**
+     * @brief Set the root's level; called by LoggingEngine::setLogLevel()
+     */
+    static void setRootLevel(utils::LogLevel level) noexcept;
+
+    /**
+     * @brief Set or clear the own level and recompute the subtree, with the registry lock held
+     */
+    void assignLocked(std::optional<utils::LogLevel> level) noexcept;
+
+    alignas(64) std::atomic<utils::LogLevel> effectiveLevel;    ///< Own level or inherited one, read by every check
+    std::optional<utils::LogLevel> ownLevel;                    ///< Level set on this logger, guarded by the registry lock
+    std::string fullName;                                       ///< Dot-separated name
+    Logger* parentLogger;                                       ///< nullptr for the root
+    std::vector<Logger*> children;                              ///< Direct children, guarded by the registry lock
+};
@@ -1,22 +1,63 @@
 #pragma once
 
 #include "utils.hpp"
+#include "formatArgs.hpp"
+#include "rateLimit.hpp"
 #include "logSink.hpp"
 #include <fmt/format.h>
 #include <memory>
 #include <mutex>
 #include <vector>
-#include <queue>
 #include <thread>
-#include <condition_variable>
+#include <atomic>
 #include <latch>
 #include <semaphore>
 #include <source_location>
 #include "logEventRouter.hpp"
+#include "ringBuffer.hpp"
 
+#include <array>
+#include <chrono>
+#include <string>
 
+class Logger;
 
+/**
+ * @brief Capacity and overflow behaviour of the async queue
+ *
+ * A producer that finds the queue at capacity, in events or in bytes, applies the overflow
+ * policy. Every discarded event is counted per level; the logging thread reports new drops
+ * as a WARNING record at most once per reportInterval.
+ */
+struct QueuePolicy {
+    std::size_t capacity = 16384;                                   /**< Queued events at most, clamped to the ring size */
+    std::size_t maxBytes = 0;                                       /**< Queued bytes at most (events plus overflow buffers), 0 for no limit */
+    utils::OverflowPolicy overflow = utils::OverflowPolicy::BLOCK;  /**< What to do when the queue is full */
+    utils::LogLevel dropBelow = utils::LogLevel::WARNING;           /**< DROP_BELOW_LEVEL: levels under this are discarded */
+    uint32_t sampleRate = 100;                                      /**< SAMPLE: one event in this many is kept */
+    std::chrono::milliseconds reportInterval{1000};                 /**< Shortest gap between two drop reports */
+};
 
+/**
+ * @brief Point-in-time view of the engine's own counters
+ *
+ * Counters are totals since the engine started. They are read without stopping the producers,
+ * so counters of different fields may be a few events apart.
+ */
+struct EngineMetrics {
+    std::array<uint64_t, utils::LEVEL_COUNT> enqueued{};    /**< Events pushed to the async queue, per level */
+    std::array<uint64_t, utils::LEVEL_COUNT> routed{};      /**< Events handed to the router, sync and async, per level */
+    std::array<uint64_t, utils::LEVEL_COUNT> dropped{};     /**< Events discarded by the overflow policy, per level */
+    std::size_t queueDepth{0};                              /**< Events waiting in the async queue */
+    std::size_t queueHighWater{0};                          /**< Deepest the async queue has been */
+    utils::LatencyHistogram enqueueLatency;                 /**< From event creation to the event being queued */
+    std::vector<SinkMetrics> sinks;                         /**< Per-sink write statistics, in subscription order */
+
+    /**
+     * @brief One-line summary: totals, queue depth and latency percentiles of the engine and each sink
+     */
+    [[nodiscard]] std::string toString() const;
+};
 
 /**
  * @class LoggingEngine
@@ -28,6 +69,7 @@
  * - Asynchronous logging capabilities
  * - Log level filtering
  * - Thread-safe logging operations
+ * - Self-instrumentation: per-level counters, queue depth and latency histograms (see metrics())
  */
 class LoggingEngine {
 public:
@@ -39,17 +81,56 @@ public:
     
     /**
      * @brief Set the global log level for the logger
+     *
+     * This is the level of the root Logger; named loggers without a level of their own
+     * inherit it.
+     *
      * @param level The log level to set
      */
     void setLogLevel(utils::LogLevel level) noexcept;
 
     /**
-     * @brief Add a logging sink with associated level
+     * @brief Check whether a level passes the global log level
+     *
+     * A single relaxed atomic load, cheap enough to run before any argument is evaluated.
+     *
+     * @param level The log level to test
+     * @return true if messages at this level should be logged
+     */
+    [[nodiscard]] static bool isEnabled(utils::LogLevel level) noexcept {
+        return level >= globalLogLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Add a logging sink receiving every level from a minimum up
      * @param sink Smart pointer to the sink implementation
      * @param level Minimum log level for this sink
      */
     void addSink(std::shared_ptr<LogSink> sink, utils::LogLevel level);
 
+    /**
+     * @brief Add a logging sink receiving a chosen set of levels
+     * @param sink Smart pointer to the sink implementation
+     * @param levels Levels routed to the sink, e.g. utils::levelBit(ERROR) | utils::levelBit(CRITICAL)
+     */
+    void addSink(std::shared_ptr<LogSink> sink, utils::LevelMask levels);
+
+    /**
+     * @brief Replace every logging sink with a new set, atomically
+     *
+     * Events are routed either to the old set or to the new one, never to a mix. Producers
+     * are not held up: the new routing table is built by the calling thread and published in
+     * one pointer swap.
+     *
+     * @param routes The sinks and their levels
+     */
+    void setSinks(std::vector<SinkRoute> routes);
+
+    /**
+     * @brief Remove every logging sink
+     */
+    void clearSinks();
+
     /**
      * @brief Process a logging event
      * @param event The event to process
@@ -57,19 +138,137 @@ public:
     void processEvent(const utils::LogEvent& event) noexcept;
 
     /**
-     * @brief Log a message with formatting
+     * @brief Process a logging event, moving it into the async queue when possible
+     * @param event The event to process
+     */
+    void processEvent(utils::LogEvent&& event) noexcept;
+
+    /**
+     * @brief Log a message with a format string known at compile time
+     *
+     * The LOG_* macros pass string literals this way. A format string that does not match the
+     * arguments fails the build; when the message is formatted on the caller's thread, it
+     * goes through code generated for this format instead of parsing it.
+     *
+     * In async mode with FormatMode::DEFERRED, the call site id and a copy of the arguments
+     * are queued and the message is formatted on the logging thread. Arguments that cannot be
+     * captured by value fall back to formatting on the caller's thread.
+     *
+     * Fields passed through utils::kv() are captured the same way in every mode, so sinks get
+     * them typed; outside deferred mode the message is rendered right away on the caller's thread.
+     *
+     * @param site Static description of the call, see LOGGERCPP_CALL_SITE
+     * @param fmt The format string, see LOGGERCPP_FORMAT
+     * @param args Arguments to format into the message, fields in any position
+     */
+    template<utils::FixedString Format, typename... Args>
+    void log(const utils::CallSite& site, utils::CompiledFormat<Format> fmt, Args&&... args) noexcept {
+        [[maybe_unused]] constexpr utils::PositionalFormatString<Args...> checked(Format.view());
+        if (!isEnabled(site.level)) [[unlikely]] return;
+        logFormatted(site, fmt, args...);
+    }
+
+    /**
+     * @brief Log a message with a format string known only at run time
+     *
+     * Formatted like the compile-time overload, but a bad format string is only reported inside
+     * the message. Deferred formatting needs the site to hold the format string.
+     *
+     * @param site Static description of the call
+     * @param fmt Format string
+     * @param args Arguments to format into the message, fields in any position
+     */
+    template<typename... Args>
+    void log(const utils::CallSite& site, fmt::string_view fmt, Args&&... args) noexcept {
+        if (!isEnabled(site.level)) [[unlikely]] return;
+        logFormatted(site, fmt, args...);
+    }
+
+    /**
+     * @brief Log a message from a location known only at run time
+     *
+     * Looks the location up in utils::CallSiteRegistry::intern(); the LOG_* macros avoid that
+     * with a static call site. The site keeps the format, so it can be deferred like theirs.
+     *
+     * @param level The log level for this message
+     * @param location Source code location information
+     * @param fmt Format string literal
+     * @param args Arguments to format into the message
+     */
+    template<std::size_t N, typename... Args>
+    void log(utils::LogLevel level, const std::source_location& location, const char (&fmt)[N], Args&&... args) noexcept {
+        log(utils::CallSiteRegistry::intern(level, location, fmt), fmt::string_view(fmt), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Log a message from a location known only at run time, formatted on the caller's thread
+     *
+     * Taken for formats that may not outlive the call (a buffer, std::string::c_str()): the site
+     * does not keep them.
+     *
      * @param level The log level for this message
      * @param location Source code location information
      * @param fmt Format string
      * @param args Arguments to format into the message
      */
+    template<std::size_t N, typename... Args>
+    void log(utils::LogLevel level, const std::source_location& location, char (&fmt)[N], Args&&... args) noexcept {
+        log(level, location, std::string_view(fmt), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Log a message from a location known only at run time, formatted on the caller's thread
+     * @param level The log level for this message
+     * @param location Source code location information
+     * @param fmt Format string, not kept by the site
+     * @param args Arguments to format into the message
+     */
     template<typename... Args>
-    void log(utils::LogLevel level, const std::source_location& location, const std::string& fmt, Args&&... args) noexcept {
-        std::string formattedMessage = fmt::vformat(fmt, fmt::make_format_args(std::forward<Args>(args)...));
-        utils::LogEvent event{level, formattedMessage, location};
-        processEvent(std::move(event));
+    void log(utils::LogLevel level, const std::source_location& location, std::string_view fmt, Args&&... args) noexcept {
+        log(utils::CallSiteRegistry::intern(level, location, nullptr), fmt::string_view(fmt.data(), fmt.size()), std::forward<Args>(args)...);
     }
 
+    /**
+     * @brief Set capacity and overflow behaviour of the async queue
+     *
+     * May be called at any time; events already queued above a lowered capacity stay queued.
+     *
+     * @param policy The new queue policy
+     */
+    void setQueuePolicy(const QueuePolicy& policy) noexcept;
+
+    /**
+     * @brief Number of events discarded by the overflow policy so far
+     * @param level Level of the discarded events
+     * @return Events of this level dropped since the engine started
+     */
+    [[nodiscard]] uint64_t droppedEvents(utils::LogLevel level) const noexcept;
+
+    /**
+     * @brief Snapshot of the engine's counters and histograms
+     *
+     * Producers count into per-thread shards without locking; this sums the shards, so it is
+     * meant for periodic polling rather than for every event.
+     */
+    [[nodiscard]] EngineMetrics metrics() const;
+
+    /**
+     * @brief Have the logging thread write metrics().toString() to a sink at a fixed interval
+     *
+     * The report is an INFO event written straight to this sink, not routed, so it does not
+     * need to be registered with addSink(). Reports are only written in async mode.
+     *
+     * @param sink Sink receiving the reports, nullptr to stop reporting
+     * @param interval Time between two reports
+     */
+    void setMetricsSink(std::shared_ptr<LogSink> sink, std::chrono::milliseconds interval = std::chrono::seconds(10));
+
+    /**
+     * @brief Select where asynchronous messages get formatted
+     * @param mode FormatMode::DEFERRED (default) or FormatMode::IMMEDIATE
+     */
+    void setFormatMode(utils::FormatMode mode) noexcept;
+
     /**
      * @brief Enable asynchronous logging mode
      */
@@ -77,10 +276,15 @@ public:
 
     /**
      * @brief Disable asynchronous logging mode
+     *
+     * Returns once the logging thread has written out the queue. An event pushed by a producer
+     * that was still inside log() is written by that producer before its call returns.
      */
     void stopAsync() noexcept;
 
 private:
+    friend class Logger;
+
     /**
      * @brief Default constructor - private for singleton pattern
      */
@@ -102,6 +306,140 @@ private:
      */
     void processEventQueue() noexcept;
 
+    /**
+     * @brief Queue or route an event whose level was already checked
+     *
+     * Events of named loggers come this way: their level is the logger's, not the global one.
+     *
+     * @param event The event to process
+     */
+    void dispatch(utils::LogEvent&& event) noexcept;
+
+    /**
+     * @brief Wake the logging thread if it is parked waiting for events
+     */
+    void wakeConsumer() noexcept;
+
+    /**
+     * @brief Claim queue capacity for an event, applying the overflow policy when there is none
+     * @param event The event about to be queued
+     * @return false if the event has to be discarded
+     */
+    bool admit(const utils::LogEvent& event) noexcept;
+
+    /**
+     * @brief Claim capacity for one event of the given size, without waiting
+     * @param bytes Footprint of the event
+     * @return true if the event fits within capacity and maxBytes
+     */
+    bool tryReserve(std::size_t bytes) noexcept;
+
+    /**
+     * @brief Return the capacity held by a dequeued event
+     * @param bytes Footprint of the event when it was queued
+     */
+    void release(std::size_t bytes) noexcept;
+
+    /**
+     * @brief Count a discarded event
+     * @param level Level of the event
+     */
+    void countDrop(utils::LogLevel level) noexcept;
+
+    /**
+     * @brief Route a WARNING record summarising drops since the last report, if any
+     * @param force Report even if the last report is more recent than the report interval
+     */
+    void reportDrops(bool force = false) noexcept;
+
+    /**
+     * @brief Write a metrics report to the metrics sink if the report interval has passed
+     */
+    void reportMetrics() noexcept;
+
+    /**
+     * @brief Counters written by one group of threads, on cache lines of their own
+     */
+    struct alignas(64) MetricShard {
+        std::array<std::atomic<uint64_t>, utils::LEVEL_COUNT> enqueued{};  ///< See EngineMetrics::enqueued
+        std::array<std::atomic<uint64_t>, utils::LEVEL_COUNT> routed{};    ///< See EngineMetrics::routed
+        utils::AtomicLatencyHistogram enqueueLatency;                       ///< See EngineMetrics::enqueueLatency
+    };
+
+    /**
+     * @brief Shard of the calling thread, picked round-robin on the thread's first call
+     */
+    [[nodiscard]] MetricShard& localShard() noexcept;
+
+    /**
+     * @brief Pop up to BATCH_SIZE events, render deferred messages and route them as one batch
+     * @return Number of events routed
+     */
+    std::size_t drainBatch() noexcept;
+
+    /**
+     * @brief Shared body of the log() overloads: defers or captures the arguments when it can
+     *
+     * Does not test the level; the engine's log() overloads test the global one, Logger::log()
+     * callers the logger's.
+     *
+     * @param site Static description of the call
+     * @param fmt Format string, compiled or not
+     * @param args Arguments to format into the message, fields in any position
+     */
+    template<typename Format, typename... Args>
+    void logFormatted(const utils::CallSite& site, const Format& fmt, const Args&... args) noexcept {
+        if constexpr ((utils::isDeferrableArg<std::decay_t<Args>> && ...)) {
+            const bool deferred = asyncMode.load(std::memory_order_relaxed) && formatMode.load(std::memory_order_relaxed) == utils::FormatMode::DEFERRED;
+            if ((deferred || utils::hasFieldArgs<Args...>) && site.format.data() != nullptr) {
+                utils::LogEvent event{site};
+                if (utils::encodeArgs(event, args...)) [[likely]] {
+                    if (!deferred) {
+                        event.setRenderedMessage(formatMessage(fmt, args...));
+                    }
+                    dispatch(std::move(event));
+                    return;
+                }
+            }
+        }
+        dispatch(utils::LogEvent{site, formatMessage(fmt, args...)});
+    }
+
+    /**
+     * @brief Format a message on the calling thread, reporting format errors in the result
+     *
+     * Formats into a per-thread buffer that keeps its capacity, so eager formatting does not
+     * allocate once the buffer has grown to the thread's typical message size.
+     *
+     * @param fmt Format string, compiled or not
+     * @param args Arguments to format into the message
+     * @return View of the formatted message, valid until the thread's next call
+     */
+    template<typename Format, typename... Args>
+    [[nodiscard]] static std::string_view formatMessage(const Format& fmt, const Args&... args) noexcept {
+        static thread_local fmt::memory_buffer buffer;
+        buffer.clear();
+        try {
+            if constexpr (utils::hasFieldArgs<Args...>) {
+                utils::formatWithFields(buffer, fmt, args...);
+            } else {
+                utils::formatTo(buffer, fmt, args...);
+            }
+        } catch (const std::exception& e) {
+            buffer.clear();
+            fmt::format_to(fmt::appender(buffer), "[format error: {}] {}", e.what(), utils::formatText(fmt));
+        }
+        return {buffer.data(), buffer.size()};
+    }
+
+    /**
+     * @brief Buffers for rendering deferred messages on the calling thread, kept per thread
+     */
+    [[nodiscard]] static utils::FormatScratch& callerScratch() noexcept {
+        static thread_local utils::FormatScratch scratch;
+        return scratch;
+    }
+
     /**
      * @brief Check if a log event should be processed
      * @param eventLevel Log level of the event
@@ -110,13 +448,35 @@ private:
      */
 
     alignas(64) LogEventRouter router;                                                       ///< Event router for log messages
-    alignas(64) utils::LogLevel globalLogLevel;                                              ///< Global minimum log level
-    alignas(64) std::vector<std::pair<std::shared_ptr<LogSink>, utils::LogLevel>> sinks;    ///< Logging sinks with levels
-    std::mutex sinkMutex;                                                                    ///< Mutex for sink operations
-    alignas(64) std::queue<utils::LogEvent> eventQueue;                                      ///< Queue for async logging
-    std::mutex queueMutex;                                                                   ///< Mutex for queue operations
-    std::condition_variable queueCV;                                                         ///< Condition for queue processing
+    alignas(64) static inline std::atomic<utils::LogLevel> globalLogLevel{utils::LogLevel::INFO};  ///< Global minimum log level
+    static constexpr std::size_t QUEUE_CAPACITY = 16384;                                     ///< Preallocated slots in the async queue
+    static constexpr std::size_t BATCH_SIZE = 256;                                           ///< Events routed per batch by the logging thread
+    static constexpr std::chrono::milliseconds IDLE_TIMEOUT{100};                            ///< Longest the logging thread parks without a wakeup
+    static constexpr std::size_t METRIC_SHARDS = 16;                                         ///< Shards the producers' counters are spread over
+    alignas(64) RingBuffer<utils::LogEvent> eventQueue{QUEUE_CAPACITY};                      ///< Lock-free queue for async logging
+    alignas(64) std::atomic<std::size_t> queuedEvents{0};                                    ///< Events admitted and not yet dequeued
+    std::atomic<std::size_t> queueHighWater{0};                                              ///< Largest queuedEvents seen
+    std::atomic<std::size_t> queuedBytes{0};                                                 ///< Footprint of the admitted events
+    alignas(64) std::atomic<std::size_t> queueCapacity{QUEUE_CAPACITY};                      ///< QueuePolicy::capacity
+    std::atomic<std::size_t> queueMaxBytes{0};                                               ///< QueuePolicy::maxBytes
+    std::atomic<utils::OverflowPolicy> overflowPolicy{utils::OverflowPolicy::BLOCK};         ///< QueuePolicy::overflow
+    std::atomic<utils::LogLevel> dropBelow{utils::LogLevel::WARNING};                        ///< QueuePolicy::dropBelow
+    std::atomic<uint32_t> sampleRate{100};                                                   ///< QueuePolicy::sampleRate
+    std::atomic<int64_t> reportIntervalMs{1000};                                             ///< QueuePolicy::reportInterval
+    std::atomic<uint64_t> overflowCount{0};                                                  ///< Events that met a full queue, drives SAMPLE
+    alignas(64) std::array<std::atomic<uint64_t>, utils::LEVEL_COUNT> droppedByLevel{};      ///< Discarded events per level
+    std::array<uint64_t, utils::LEVEL_COUNT> reportedDrops{};                                ///< droppedByLevel at the last report, logging thread only
+    std::chrono::steady_clock::time_point lastDropReport{};                                  ///< Time of the last report, logging thread only
+    std::array<MetricShard, METRIC_SHARDS> metricShards;                                     ///< Sharded producer counters
+    std::atomic<std::shared_ptr<LogSink>> metricsSink;                                       ///< Receives periodic reports, may be null
+    std::atomic<int64_t> metricsIntervalMs{10000};                                           ///< Time between two reports
+    std::chrono::steady_clock::time_point lastMetricsReport{};                               ///< Time of the last report, logging thread only
+    alignas(64) std::atomic<bool> consumerSleeping{false};                                   ///< Set while the logging thread is parked
     std::binary_semaphore queueSem{0};                                                      ///< Semaphore for queue signaling
+    std::mutex lifecycleMutex;                                                               ///< Mutex for starting/stopping async mode
+    utils::FormatScratch formatScratch;                                                      ///< Buffers for rendering deferred messages, logging thread or lifecycleMutex holder
+    std::vector<utils::LogEvent> batch;                                                      ///< Events being routed, logging thread or lifecycleMutex holder
+    std::atomic<utils::FormatMode> formatMode{utils::FormatMode::DEFERRED};                  ///< Where async messages get formatted
     std::atomic<bool> asyncMode{false};                                                      ///< Flag for async mode
     std::atomic<bool> stopLogging{false};                                                    ///< Flag to stop logging
     std::jthread loggingThread;                                                             ///< Thread for async logging
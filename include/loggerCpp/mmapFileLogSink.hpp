@@ -0,0 +1,181 @@
+#pragma once
+
+#include "logSink.hpp"
+#include "timestampFormatter.hpp"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief On-disk header at the start of every memory-mapped segment
+ *
+ * The committed offset is advanced after every record is copied in, so after a crash a reader
+ * knows exactly where valid data ends even though the file itself is preallocated.
+ */
+struct MmapSegmentHeader {
+    static constexpr char MAGIC[8] = {'L', 'C', 'P', 'P', 'S', 'E', 'G', '1'};  /**< File signature */
+    static constexpr uint32_t VERSION = 1;                                          /**< Layout version */
+
+    char magic[8];                      /**< MAGIC */
+    uint32_t version;                   /**< VERSION */
+    uint32_t headerSize;                /**< Offset of the first record */
+    uint64_t capacity;                  /**< Preallocated size of the file */
+    uint64_t sequence;                  /**< Segment number */
+    std::atomic<uint64_t> committed;    /**< Offset one past the last complete record */
+};
+
+/**
+ * @brief Segment sizing and retention of a MmapFileLogSink
+ */
+struct MmapSegmentPolicy {
+    std::size_t segmentSize = 64 * 1024 * 1024; /**< Preallocated bytes per segment file */
+    std::size_t maxSegments = 0;                /**< Completed segments kept, 0 keeps all */
+};
+
+/**
+ * @brief Memory-mapped, preallocated segment file sink
+ *
+ * Writes text records straight into shared file mappings named base.000001.log, base.000002.log, ...
+ * Each segment is allocated up front with posix_fallocate and mapped once, so appending a
+ * record is a memcpy with no system call; data already copied survives a process crash in
+ * the page cache. A background thread creates and maps the next segment ahead of time and
+ * unmaps, trims and expires completed ones.
+ *
+ * If the next segment cannot be created (disk full, out of descriptors), records that do not
+ * fit the current segment are dropped and counted (droppedRecords()) while creation is retried
+ * about once a second.
+ */
+class MmapFileLogSink final : public LogSink {
+public:
+    /**
+     * @brief Constructs a MmapFileLogSink writing segments next to the given base path
+     *
+     * @param basePath Path prefix of the segment files
+     * @param policy Segment size and retention
+     * @throws std::runtime_error if the first segment cannot be created
+     */
+    explicit MmapFileLogSink(std::string_view basePath, const MmapSegmentPolicy& policy = {});
+
+    /**
+     * @brief Trims the current segment to its committed size and stops the background thread
+     */
+    ~MmapFileLogSink() noexcept override;
+
+    /**
+     * @brief Writes a log event into the current segment
+     *
+     * @param event The log event containing the message and metadata to be written
+     */
+    void write(const utils::LogEvent& event) override;
+
+    /**
+     * @brief Writes a batch of log events into the current segment
+     *
+     * @param events The events to be written, in order
+     */
+    void writeBatch(std::span<const utils::LogEvent> events) override;
+
+    /**
+     * @brief Records lost because no new segment could be switched to
+     */
+    [[nodiscard]] uint64_t droppedRecords() const noexcept;
+
+    /**
+     * @brief Reads the valid records of a segment file
+     *
+     * @param segmentPath Path of a segment written by this sink
+     * @return Text between the header and the committed offset
+     * @throws std::runtime_error if the file is not a valid segment
+     */
+    [[nodiscard]] static std::string readSegment(std::string_view segmentPath);
+
+private:
+    /**
+     * @brief A mapped segment file
+     */
+    struct Segment {
+        int fd{-1};                         /**< Open file descriptor */
+        char* base{nullptr};                /**< Start of the mapping */
+        std::size_t capacity{0};            /**< Mapped size */
+        uint64_t sequence{0};               /**< Segment number */
+
+        /**
+         * @brief The header at the start of the mapping
+         */
+        [[nodiscard]] MmapSegmentHeader& header() const noexcept { return *reinterpret_cast<MmapSegmentHeader*>(base); }
+    };
+
+    /**
+     * @brief Copies one rendered record into the current segment, switching segments if needed
+     * @param record The rendered record
+     */
+    void append(std::string_view record);
+
+    /**
+     * @brief Replaces the current segment with the pre-created next one
+     *
+     * Waits a bounded time for a segment still being created; if there is none, keeps the
+     * current segment and schedules another attempt.
+     *
+     * @return false if the current segment was kept
+     */
+    bool switchSegment();
+
+    /**
+     * @brief Creates, preallocates and maps a segment file
+     * @param sequence Segment number
+     * @return The mapped segment, or nullptr on failure
+     */
+    [[nodiscard]] std::unique_ptr<Segment> createSegment(uint64_t sequence) const;
+
+    /**
+     * @brief Unmaps a completed segment, trims it to its committed size and applies retention
+     * @param segment The segment to retire
+     */
+    void retireSegment(std::unique_ptr<Segment> segment) const;
+
+    /**
+     * @brief Body of the background thread
+     * @param stop Stop token of the thread
+     */
+    void segmentLoop(std::stop_token stop);
+
+    /**
+     * @brief Path of the segment with the given number
+     */
+    [[nodiscard]] std::string segmentPath(uint64_t sequence) const;
+
+    /**
+     * @brief Numbers of the segment files present next to the base path, ascending
+     */
+    [[nodiscard]] std::vector<uint64_t> existingSegments() const;
+
+    std::string basePath;                               /**< Path prefix of segment files */
+    MmapSegmentPolicy policy;                           /**< Segment size and retention */
+    utils::TimestampFormatter timestampFormatter;       /**< Cached renderer for event timestamps */
+    utils::CallSiteTextCache locations;                 /**< Location text rendered once per call site */
+    fmt::memory_buffer record;                          /**< Scratch buffer for one rendered record */
+    std::unique_ptr<Segment> current;                   /**< Segment being written */
+    uint64_t writeOffset{0};                            /**< Next write position in current */
+    bool segmentFull{false};                            /**< current is full and no next segment was ready */
+    std::atomic<Segment*> nextSegment{nullptr};         /**< Pre-created next segment, owned by whoever holds it */
+    std::atomic<uint64_t> dropped{0};                   /**< See droppedRecords() */
+    std::mutex segmentMutex;                            /**< Guards the members below */
+    std::condition_variable_any segmentCV;              /**< Wakes the background thread */
+    std::vector<std::unique_ptr<Segment>> retiredSegments; /**< Completed segments waiting to be unmapped */
+    bool prepareNext{false};                            /**< Whether the background thread should create the next segment */
+    bool preparing{false};                              /**< From the request until the result is in nextSegment */
+    uint64_t nextSequence{0};                           /**< Number of the segment to create next */
+    std::chrono::steady_clock::time_point nextRetry{};  /**< Earliest time to retry after a failed creation */
+    std::jthread segmentThread;                         /**< Background segment creation and retirement */
+};
@@ -2,35 +2,217 @@
 
 #include "logSink.hpp"
 
+#include <fmt/format.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Wire format of a NetworkLogSink
+ */
+enum class NetworkFormat : uint8_t {
+    SYSLOG,         /**< RFC 5424 messages; octet-counted (RFC 6587) over TCP, one per datagram over UDP */
+    JSON_LINES      /**< One JSON object per line over TCP, one per datagram over UDP */
+};
+
+/**
+ * @brief Format, batching and reconnect behaviour of a NetworkLogSink
+ */
+struct NetworkSinkOptions {
+    NetworkFormat format = NetworkFormat::SYSLOG;           /**< Wire format */
+    std::string appName = "loggerCpp";                      /**< APP-NAME field / "app" key */
+    int facility = 1;                                       /**< Syslog facility code, 1 is user-level */
+    std::chrono::milliseconds linger{5};                    /**< How long a record may wait for more to share its send */
+    std::size_t batchBytes = 64 * 1024;                     /**< Pending bytes that trigger a send without waiting for linger */
+    std::size_t maxPendingBytes = 4 * 1024 * 1024;          /**< Unsent bytes kept while the peer is slow or away; newer records are dropped */
+    std::chrono::milliseconds reconnectMin{100};            /**< First reconnect delay, doubled after every failure */
+    std::chrono::milliseconds reconnectMax{30000};          /**< Longest reconnect delay */
+    std::chrono::milliseconds closeTimeout{1000};           /**< How long the destructor keeps trying to send what is left */
+};
+
+/**
+ * @brief Delivery counters of a NetworkLogSink
+ */
+struct NetworkSinkStats {
+    uint64_t sent{0};               /**< Records handed to the kernel */
+    uint64_t dropped{0};            /**< Records discarded: buffer full, send error or shutdown */
+    uint64_t connects{0};           /**< Successful (re)connections */
+    std::size_t pendingBytes{0};    /**< Bytes waiting to be sent */
+    bool connected{false};          /**< Whether a connection is currently up */
+};
+
 /**
  * @brief Network output sink for logging
- * 
- * This class implements a logging sink that writes log messages to a network destination.
- * It inherits from the LogSink base class and provides network-specific logging functionality.
+ *
+ * Sends records to a remote collector over TCP or UDP, as RFC 5424 syslog or JSON lines.
+ * The logging thread only formats records into a pending buffer; a sender thread owned by
+ * the sink waits up to options.linger for more records, then writes the whole buffer with one
+ * send() (TCP) or sendmmsg() (UDP) on a non-blocking socket.
+ *
+ * When the collector is unreachable the sender reconnects with exponential backoff while up
+ * to maxPendingBytes are kept; records beyond that are dropped and counted. Nothing in the
+ * write path throws on network errors.
+ *
+ * @code
+ * engine.addSink(std::make_shared<NetworkLogSink>("tcp://logs.example.com:601"), utils::LogLevel::INFO);
+ * @endcode
  */
 class NetworkLogSink final : public LogSink {
 public:
     /**
-     * @brief Default constructor
-     * 
-     * Constructs a NetworkLogSink object that can write log messages to a network destination.
+     * @brief Constructs a NetworkLogSink and starts its sender thread
+     *
+     * The connection is made by the sender thread, so an unreachable collector does not fail
+     * construction.
+     *
+     * @param url Destination, "tcp://host:port" or "udp://host:port" (IPv6 hosts in brackets, port defaults to 514)
+     * @param options Format, batching and reconnect behaviour
+     * @throws std::invalid_argument If the URL cannot be parsed
      */
-    NetworkLogSink() noexcept = default;
+    explicit NetworkLogSink(std::string_view url, const NetworkSinkOptions& options = {});
 
     /**
-     * @brief Constructor with URL
-     * 
-     * Constructs a NetworkLogSink object that can write log messages to a network destination.
+     * @brief Sends what is still pending, for at most options.closeTimeout, and stops the sender thread
      */
-    NetworkLogSink(const std::string_view& url);
+    ~NetworkLogSink() noexcept override;
 
     /**
-     * @brief Writes a log event to the network destination
-     * 
+     * @brief Queues a log event for sending
+     *
      * @param event The log event containing the message and metadata to be written
-     * @throws None This function is noexcept
-     * 
-     * This function formats and writes the provided log event to the configured network destination.
      */
     void write(const utils::LogEvent& event) override;
-};
\ No newline at end of file
+
+    /**
+     * @brief Queues a batch of log events for sending, taking the buffer lock once
+     *
+     * @param events The events to be written, in order
+     */
+    void writeBatch(std::span<const utils::LogEvent> events) override;
+
+    /**
+     * @brief Asks the sender thread to send pending records without waiting for linger
+     */
+    void flush() override;
+
+    /**
+     * @brief Current delivery counters, safe to call from any thread
+     */
+    [[nodiscard]] NetworkSinkStats stats() const noexcept;
+
+private:
+    /**
+     * @brief Transport protocol taken from the URL scheme
+     */
+    enum class Protocol : uint8_t { TCP, UDP };
+
+    /**
+     * @brief Formats one event into record, without the TCP syslog octet count
+     * @param event The event to format
+     */
+    void formatRecord(const utils::LogEvent& event);
+
+    /**
+     * @brief Renders a timestamp as RFC 3339 UTC with microseconds, logging thread only
+     * @param timestamp Nanoseconds since the Unix epoch
+     * @return View into an internal buffer, valid until the next call
+     */
+    std::string_view formatTimestamp(uint64_t timestamp) noexcept;
+
+    /**
+     * @brief Body of the sender thread
+     */
+    void senderLoop() noexcept;
+
+    /**
+     * @brief Moves pending records to the sending buffer, waiting for them and for linger
+     * @param lock Lock on mutex, held on entry and exit
+     * @return false once the sink is stopping and nothing is left to send
+     */
+    bool takePending(std::unique_lock<std::mutex>& lock) noexcept;
+
+    /**
+     * @brief Resolves the host and opens a connected non-blocking socket
+     * @return true if connected
+     */
+    bool connect() noexcept;
+
+    /**
+     * @brief Closes the socket and schedules the next connection attempt
+     */
+    void disconnect() noexcept;
+
+    /**
+     * @brief Sends as much of the sending buffer as the socket takes
+     * @return false if the connection failed and was closed
+     */
+    bool transmit() noexcept;
+
+    /**
+     * @brief Stream send for TCP, see transmit()
+     */
+    bool transmitStream() noexcept;
+
+    /**
+     * @brief Datagram send for UDP, one record per datagram, see transmit()
+     */
+    bool transmitDatagrams() noexcept;
+
+    /**
+     * @brief Marks sending records as done and returns their bytes to the budget
+     * @param records Records from the front of what is left to send
+     * @param delivered Whether they were sent (true) or dropped (false)
+     */
+    void completeRecords(std::size_t records, bool delivered) noexcept;
+
+    Protocol protocol;                                      /**< TCP or UDP */
+    std::string host;                                       /**< Host name or address to resolve */
+    std::string port;                                       /**< Service port */
+    NetworkSinkOptions options;                             /**< Format, batching and reconnect behaviour */
+    std::string hostname;                                   /**< HOSTNAME field, sanitised at construction */
+    std::string appName;                                    /**< APP-NAME field, sanitised at construction */
+    int processId;                                          /**< PROCID field */
+
+    // Logging thread only
+    fmt::memory_buffer record;                              /**< Record being formatted */
+    utils::CallSiteTextCache locations;                     /**< Escaped "file", "line" and "function" values by call site */
+    fmt::memory_buffer staging;                             /**< Records of the current batch */
+    std::vector<uint32_t> stagingSizes;                     /**< Size of each staged record */
+    int64_t cachedSecond{-1};                               /**< Second the timestamp prefix was built for */
+    char timestampText[32]{};                               /**< "YYYY-MM-DDTHH:MM:SS" prefix, then fraction and "Z" */
+
+    // Shared with the sender thread, guarded by mutex
+    std::mutex mutex;                                       /**< Guards the pending buffer and flags */
+    std::condition_variable wake;                           /**< Wakes the sender thread */
+    std::string pending;                                    /**< Records waiting for the sender */
+    std::vector<uint32_t> pendingSizes;                     /**< Size of each pending record */
+    std::chrono::steady_clock::time_point firstPending;     /**< When pending last went from empty to non-empty */
+    bool flushRequested{false};                             /**< Set by flush(), cleared when pending is taken */
+    bool stopping{false};                                   /**< Set by the destructor */
+
+    // Sender thread only
+    std::string sending;                                    /**< Records being sent */
+    std::vector<uint32_t> sendingSizes;                     /**< Size of each record being sent */
+    std::size_t sendingRecord{0};                           /**< First record not completely sent */
+    std::size_t sendingCompleted{0};                        /**< Bytes of the records before sendingRecord */
+    std::size_t sendingOffset{0};                           /**< Bytes of sending already sent, TCP only */
+    int socketFd{-1};                                       /**< Connected socket, -1 when disconnected */
+    std::chrono::milliseconds backoff{0};                   /**< Delay before the next attempt after a failure */
+    std::chrono::steady_clock::time_point nextConnect;      /**< Earliest time of the next connection attempt */
+    std::chrono::steady_clock::time_point closeDeadline{std::chrono::steady_clock::time_point::max()}; /**< Give-up time once stopping */
+
+    alignas(64) std::atomic<uint64_t> sent{0};              /**< See NetworkSinkStats::sent */
+    std::atomic<uint64_t> dropped{0};                       /**< See NetworkSinkStats::dropped */
+    std::atomic<uint64_t> connects{0};                      /**< See NetworkSinkStats::connects */
+    std::atomic<std::size_t> pendingBytes{0};               /**< See NetworkSinkStats::pendingBytes */
+    std::atomic<bool> connected{false};                     /**< See NetworkSinkStats::connected */
+    std::thread sender;                                     /**< Sender thread */
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace utils {
+
+    namespace detail {
+        [[nodiscard]] inline int64_t steadyNow() noexcept {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    } // namespace detail
+
+    /**
+     * @brief Lets through the 1st, (n+1)th, (2n+1)th, ... call, see LOG_EVERY_N
+     *
+     * Every call is a single atomic increment. Lives in a function-local static of the call site.
+     */
+    class EveryN {
+    public:
+        /**
+         * @brief Constructs the limiter
+         * @param n Calls per emitted one, 0 is treated as 1
+         */
+        explicit constexpr EveryN(uint64_t n) noexcept : n(std::max<uint64_t>(n, 1)) {}
+
+        /**
+         * @brief Counts a call and decides whether it is logged
+         * @param suppressed Receives the calls dropped since the previous logged one, if logged
+         * @return true if the call should be logged
+         */
+        bool tryAcquire(uint64_t& suppressed) noexcept {
+            const uint64_t call = calls.fetch_add(1, std::memory_order_relaxed);
+            if (call % n != 0) return false;
+            suppressed = call == 0 ? 0 : n - 1;
+            return true;
+        }
+
+    private:
+        uint64_t n;                         /**< Calls per emitted one */
+        std::atomic<uint64_t> calls{0};     /**< Calls so far */
+    };
+
+    /**
+     * @brief Lets through at most one call per interval, see LOG_EVERY_MS
+     *
+     * A suppressed call reads the steady clock and increments a counter; only the call that
+     * opens a new interval writes the deadline.
+     */
+    class EveryInterval {
+    public:
+        /**
+         * @brief Constructs the limiter
+         * @param interval Shortest time between two logged calls
+         */
+        explicit constexpr EveryInterval(std::chrono::nanoseconds interval) noexcept : interval(interval.count()) {}
+
+        /**
+         * @brief Counts a call and decides whether it is logged
+         * @param suppressed Receives the calls dropped since the previous logged one, if logged
+         * @return true if the call should be logged
+         */
+        bool tryAcquire(uint64_t& suppressed) noexcept {
+            const int64_t now = detail::steadyNow();
+            int64_t due = next.load(std::memory_order_relaxed);
+            if (now < due || !next.compare_exchange_strong(due, now + interval, std::memory_order_relaxed)) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            suppressed = dropped.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+    private:
+        int64_t interval;                   /**< Interval in steady_clock nanoseconds */
+        std::atomic<int64_t> next{0};       /**< steady_clock time from which the next call is logged */
+        std::atomic<uint64_t> dropped{0};   /**< Calls suppressed since the last logged one */
+    };
+
+    /**
+     * @brief Token bucket: a sustained rate with bursts, see LOG_RATE_LIMITED
+     *
+     * Kept as a single "theoretical arrival time" (GCRA): each logged call moves it one
+     * emission interval forward, and a call is refused while it is more than the burst ahead
+     * of now. Equivalent to a bucket of @p burst tokens refilled at @p perSecond, without a
+     * separate token count to keep consistent.
+     */
+    class TokenBucket {
+    public:
+        /**
+         * @brief Constructs the limiter
+         * @param perSecond Sustained calls per second, 0 is treated as 1
+         * @param burst Calls that may be logged back to back after a quiet period, 0 is treated as 1
+         */
+        constexpr TokenBucket(uint64_t perSecond, uint64_t burst) noexcept
+            : emission(1'000'000'000 / static_cast<int64_t>(std::clamp<uint64_t>(perSecond, 1, 1'000'000'000))),
+              tolerance(emission * static_cast<int64_t>(std::max<uint64_t>(burst, 1) - 1)) {}
+
+        /**
+         * @brief Counts a call and decides whether it is logged
+         * @param suppressed Receives the calls dropped since the previous logged one, if logged
+         * @return true if the call should be logged
+         */
+        bool tryAcquire(uint64_t& suppressed) noexcept {
+            const int64_t now = detail::steadyNow();
+            int64_t arrival = tat.load(std::memory_order_relaxed);
+            int64_t start;
+            do {
+                start = std::max(arrival, now);
+                if (start - now > tolerance) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            } while (!tat.compare_exchange_weak(arrival, start + emission, std::memory_order_relaxed));
+            suppressed = dropped.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+    private:
+        int64_t emission;                   /**< Nanoseconds per token */
+        int64_t tolerance;                  /**< How far ahead of now the arrival time may run: (burst - 1) tokens */
+        std::atomic<int64_t> tat{0};        /**< Theoretical arrival time, steady_clock nanoseconds */
+        std::atomic<uint64_t> dropped{0};   /**< Calls suppressed since the last logged one */
+    };
+
+} // namespace utils
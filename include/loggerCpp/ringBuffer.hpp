@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Bounded, preallocated lock-free ring buffer
+ *
+ * Multi-producer ring based on per-cell sequence numbers (Vyukov's bounded queue). A producer
+ * claims a slot with a single CAS on the tail index and publishes it by bumping the cell's
+ * sequence; the consumer does the same on the head index. No operation takes a lock or
+ * touches the allocator once the ring is constructed.
+ *
+ * Head, tail and every cell sit on their own cache lines so that producers hammering the
+ * tail do not false-share with the consumer draining the head.
+ *
+ * @tparam T Element type stored in the ring, must be nothrow move constructible
+ */
+template<typename T>
+class RingBuffer {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "RingBuffer requires nothrow move constructible elements");
+
+public:
+    /**
+     * @brief Constructs a ring with at least the requested capacity
+     * @param capacity Minimum number of elements, rounded up to the next power of two
+     */
+    explicit RingBuffer(std::size_t capacity)
+        : mask(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1),
+          cells(std::make_unique<Cell[]>(mask + 1)) {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Destroys any elements still left in the ring
+     */
+    ~RingBuffer() noexcept {
+        while (tryPop()) {}
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+    RingBuffer(RingBuffer&&) = delete;
+    RingBuffer& operator=(RingBuffer&&) = delete;
+
+    /**
+     * @brief Attempts to enqueue an element
+     * @param value Element to move into the ring
+     * @return true on success, false if the ring is full (value is left untouched)
+     */
+    [[nodiscard]] bool tryPush(T&& value) noexcept {
+        std::size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    ::new (static_cast<void*>(cell.storage)) T(std::move(value));
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) [[unlikely]] {
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Attempts to dequeue the oldest element
+     * @return The element, or std::nullopt if the ring is empty
+     */
+    [[nodiscard]] std::optional<T> tryPop() noexcept {
+        std::size_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* element = std::launder(reinterpret_cast<T*>(cell.storage));
+                    std::optional<T> result(std::move(*element));
+                    element->~T();
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return result;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Checks whether the ring currently holds no element ready to be popped
+     * @return true if the next pop would fail
+     */
+    [[nodiscard]] bool empty() const noexcept {
+        const std::size_t pos = head.load(std::memory_order_relaxed);
+        return cells[pos & mask].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    /**
+     * @brief Approximate number of queued elements
+     * @return Snapshot of tail minus head, may be stale under concurrency
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+
+    /**
+     * @brief Maximum number of elements the ring can hold
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept { return mask + 1; }
+
+private:
+    /**
+     * @brief Single slot of the ring, padded to a cache line
+     */
+    struct alignas(64) Cell {
+        std::atomic<std::size_t> sequence{0};          /**< Publication sequence of this slot */
+        alignas(T) std::byte storage[sizeof(T)];       /**< Raw storage for the element */
+    };
+
+    const std::size_t mask;                             /**< Capacity minus one, capacity is a power of two */
+    std::unique_ptr<Cell[]> cells;                      /**< Preallocated slots */
+    alignas(64) std::atomic<std::size_t> tail{0};      /**< Next position to produce into */
+    alignas(64) std::atomic<std::size_t> head{0};      /**< Next position to consume from */
+};
@@ -2,6 +2,9 @@
 
 #include "loggerCpp/logSink.hpp"
 
+#include <fmt/format.h>
+
+#include <string>
 #include <string_view>
 #include <syslog.h>
 
@@ -10,6 +13,9 @@
  * 
  * This class implements a logging sink that writes log messages to the system logger (syslog).
  * It inherits from the LogSink base class and provides syslog-specific logging functionality.
+ *
+ * The syslog connection is shared by the whole process: the ident of the most recently
+ * created sink is used, while each sink keeps its own facility.
  */
 class SysLogSink final : public LogSink {
 public:
@@ -22,7 +28,7 @@ public:
     explicit SysLogSink(std::string_view ident, int facility = LOG_USER);
 
     /**
-     * @brief Destructor that closes the syslog connection
+     * @brief Destructor that closes the syslog connection once no other SysLogSink uses it
      */
     ~SysLogSink() noexcept override;
 
@@ -37,6 +43,13 @@ public:
      */
     void write(const utils::LogEvent& event) override;
 
+    /**
+     * @brief Writes a batch of log events to syslog, one message each
+     *
+     * @param events The events to be written, in order
+     */
+    void writeBatch(std::span<const utils::LogEvent> events) override;
+
 private:
     /**
      * @brief Converts LogLevel to syslog priority
@@ -45,4 +58,8 @@ private:
      * @return The corresponding syslog priority
      */
     static int logLevelToSyslogPriority(utils::LogLevel level) noexcept;
+
+    int facility;                       /**< Facility added to the priority of every message */
+    utils::CallSiteTextCache locations; /**< Location text rendered once per call site */
+    fmt::memory_buffer buffer;          /**< Reused text of the message being sent */
 };
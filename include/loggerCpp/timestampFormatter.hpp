@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace utils {
+
+    /**
+     * @brief Renders raw event timestamps as local date/time text
+     *
+     * Events only carry nanoseconds since the Unix epoch. The broken-down local time and the
+     * timezone offset are recomputed once per second and cached as a text prefix; every other
+     * call only appends the sub-second digits. Not thread-safe: each sink owns its formatter
+     * and uses it from the logging thread.
+     */
+    class TimestampFormatter {
+    public:
+        /**
+         * @brief Sub-second digits appended after the seconds field
+         */
+        enum class Precision : uint8_t {
+            SECONDS,        /**< "2024-01-31 12:34:56" */
+            MILLISECONDS,   /**< "2024-01-31 12:34:56.789" */
+            MICROSECONDS    /**< "2024-01-31 12:34:56.789012" */
+        };
+
+        /**
+         * @brief Constructs a formatter
+         * @param precision Sub-second precision of the rendered text
+         * @param showOffset Append the UTC offset, e.g. " +0200"
+         */
+        explicit TimestampFormatter(Precision precision = Precision::MILLISECONDS, bool showOffset = false) noexcept;
+
+        /**
+         * @brief Formats a timestamp
+         * @param timestamp Nanoseconds since the Unix epoch, as stored in LogEvent
+         * @return View into an internal buffer, valid until the next call
+         */
+        [[nodiscard]] std::string_view format(uint64_t timestamp) noexcept;
+
+    private:
+        /**
+         * @brief Rebuilds the cached date/time prefix and offset for a new second
+         * @param seconds Seconds since the Unix epoch
+         */
+        void refresh(int64_t seconds) noexcept;
+
+        static constexpr std::size_t BUFFER_SIZE = 48;  /**< Room for date, time, fraction and offset */
+
+        Precision precision;            /**< Digits after the seconds field */
+        bool showOffset;                /**< Whether the UTC offset is appended */
+        int64_t cachedSecond{-1};       /**< Second the prefix was built for */
+        std::size_t prefixLength{0};    /**< Length of "YYYY-MM-DD HH:MM:SS" in buffer */
+        char offset[8]{};               /**< Cached " +hhmm" text */
+        char buffer[BUFFER_SIZE]{};     /**< Output buffer, starts with the cached prefix */
+    };
+
+} // namespace utils
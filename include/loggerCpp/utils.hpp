@@ -1,12 +1,20 @@
 #pragma once
 
 #include <iostream>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
 #include <source_location>
 
+#include "bufferPool.hpp"
+#include "callSite.hpp"
+#include "compiledFormat.hpp"
+
 /**
  * @brief ANSI color codes for console output formatting
  */
@@ -19,12 +27,90 @@
 #define COLOR_CYAN    "\033[36m"
 #define COLOR_WHITE   "\033[37m"
 
-#define LOG_DEBUG(msg, ...) [[unlikely]] LoggingEngine::getInstance().log(utils::LogLevel::DEBUG, std::source_location::current(), fmt::format(msg, ##__VA_ARGS__))
-#define LOG_INFO(msg, ...) [[unlikely]] LoggingEngine::getInstance().log(utils::LogLevel::INFO, std::source_location::current(), fmt::format(msg, ##__VA_ARGS__))
-#define LOG_WARNING(msg, ...) [[unlikely]] LoggingEngine::getInstance().log(utils::LogLevel::WARNING, std::source_location::current(), fmt::format(msg, ##__VA_ARGS__))
-#define LOG_ERROR(msg, ...) [[unlikely]] LoggingEngine::getInstance().log(utils::LogLevel::ERROR, std::source_location::current(), fmt::format(msg, ##__VA_ARGS__)) 
-#define LOG_CRITICAL(msg, ...) [[unlikely]] LoggingEngine::getInstance().log(utils::LogLevel::CRITICAL, std::source_location::current(), fmt::format(msg, ##__VA_ARGS__))
-#define LOG_TRACE(msg, ...) [[unlikely]] LoggingEngine::getInstance().log(utils::LogLevel::TRACE, std::source_location::current(), fmt::format(msg, ##__VA_ARGS__))
+/**
+ * @brief Lowest level compiled into LOG_* call sites
+ *
+ * Set through the LOGGERCPP_ACTIVE_LEVEL CMake option (TRACE, DEBUG, INFO, WARNING, ERROR,
+ * CRITICAL or NONE). Calls below this level expand to nothing and their arguments are never
+ * evaluated.
+ */
+#ifndef LOGGERCPP_ACTIVE_LEVEL
+#define LOGGERCPP_ACTIVE_LEVEL TRACE
+#endif
+
+/**
+ * @brief Static utils::CallSite of a LOG_* expansion, constant-initialized when msg is a literal
+ */
+#define LOGGERCPP_CALL_SITE(level, msg) \
+    static const utils::CallSite loggerCppSite{level, std::source_location::current(), utils::literalFormat(msg)}
+
+/**
+ * @brief Shared expansion of the LOG_* macros
+ *
+ * The compile-time threshold is tested first, then a relaxed load of the runtime level;
+ * arguments are only evaluated once both pass. A literal format string is checked against the
+ * arguments at compile time, see LOGGERCPP_FORMAT.
+ */
+#define LOGGERCPP_LOG(level, msg, ...) \
+    do { \
+        if constexpr ((level) >= utils::ACTIVE_LEVEL) { \
+            if (LoggingEngine::isEnabled(level)) [[unlikely]] { \
+                LOGGERCPP_CALL_SITE(level, msg); \
+                LoggingEngine::getInstance().log(loggerCppSite, LOGGERCPP_FORMAT(msg), ##__VA_ARGS__); \
+            } \
+        } \
+    } while (false)
+
+#define LOG_DEBUG(msg, ...) LOGGERCPP_LOG(utils::LogLevel::DEBUG, msg, ##__VA_ARGS__)
+#define LOG_INFO(msg, ...) LOGGERCPP_LOG(utils::LogLevel::INFO, msg, ##__VA_ARGS__)
+#define LOG_WARNING(msg, ...) LOGGERCPP_LOG(utils::LogLevel::WARNING, msg, ##__VA_ARGS__)
+#define LOG_ERROR(msg, ...) LOGGERCPP_LOG(utils::LogLevel::ERROR, msg, ##__VA_ARGS__)
+#define LOG_CRITICAL(msg, ...) LOGGERCPP_LOG(utils::LogLevel::CRITICAL, msg, ##__VA_ARGS__)
+#define LOG_TRACE(msg, ...) LOGGERCPP_LOG(utils::LogLevel::TRACE, msg, ##__VA_ARGS__)
+
+/**
+ * @brief Shared expansion of the rate-limited LOG_* macros
+ *
+ * The limiter is a function-local static, one per call site, consulted after the level
+ * checks. Refused calls stop there: no argument is evaluated, nothing is formatted or queued.
+ * The next logged call carries the number of refused ones as a "suppressed" field.
+ */
+#define LOGGERCPP_LOG_LIMITED(limiterType, limiterArgs, level, msg, ...) \
+    do { \
+        if constexpr ((level) >= utils::ACTIVE_LEVEL) { \
+            if (LoggingEngine::isEnabled(level)) [[unlikely]] { \
+                static limiterType loggerCppLimiter limiterArgs; \
+                uint64_t loggerCppSuppressed = 0; \
+                if (loggerCppLimiter.tryAcquire(loggerCppSuppressed)) { \
+                    LOGGERCPP_CALL_SITE(level, msg); \
+                    if (loggerCppSuppressed == 0) { \
+                        LoggingEngine::getInstance().log(loggerCppSite, LOGGERCPP_FORMAT(msg), ##__VA_ARGS__); \
+                    } else { \
+                        LoggingEngine::getInstance().log(loggerCppSite, LOGGERCPP_FORMAT(msg), ##__VA_ARGS__, \
+                                                         utils::kv("suppressed", loggerCppSuppressed)); \
+                    } \
+                } \
+            } \
+        } \
+    } while (false)
+
+/**
+ * @brief Logs the 1st, (n+1)th, (2n+1)th, ... call of this call site, e.g. LOG_EVERY_N(WARNING, 1000, "retry {}", id)
+ */
+#define LOG_EVERY_N(level, n, msg, ...) \
+    LOGGERCPP_LOG_LIMITED(utils::EveryN, {n}, utils::LogLevel::level, msg, ##__VA_ARGS__)
+
+/**
+ * @brief Logs at most one call of this call site per @p ms milliseconds
+ */
+#define LOG_EVERY_MS(level, ms, msg, ...) \
+    LOGGERCPP_LOG_LIMITED(utils::EveryInterval, {std::chrono::milliseconds(ms)}, utils::LogLevel::level, msg, ##__VA_ARGS__)
+
+/**
+ * @brief Logs this call site at up to @p perSecond calls per second, allowing bursts of @p burst
+ */
+#define LOG_RATE_LIMITED(level, perSecond, burst, msg, ...) \
+    LOGGERCPP_LOG_LIMITED(utils::TokenBucket, ({perSecond}, {burst}), utils::LogLevel::level, msg, ##__VA_ARGS__)
 
 
 
@@ -34,15 +120,25 @@ namespace utils {
      * @brief Enumeration of available log levels
      */
     enum class LogLevel : uint8_t {
+        TRACE,      /**< Trace level for very detailed debugging */
         DEBUG,      /**< Debug level for detailed debugging information */
         INFO,       /**< Info level for general information messages */
         WARNING,    /**< Warning level for potential issues */
         ERROR,      /**< Error level for error conditions */
         CRITICAL,   /**< Critical level for critical failures */
-        TRACE,      /**< Trace level for very detailed debugging */
         NONE        /**< No logging */
     };
 
+    /**
+     * @brief Compile-time minimum level, see LOGGERCPP_ACTIVE_LEVEL
+     */
+    inline constexpr LogLevel ACTIVE_LEVEL = LogLevel::LOGGERCPP_ACTIVE_LEVEL;
+
+    /**
+     * @brief Number of levels an event can have, NONE excluded
+     */
+    inline constexpr std::size_t LEVEL_COUNT = static_cast<std::size_t>(LogLevel::NONE);
+
     /**
      * @brief Enumeration of available sink types
      */
@@ -53,6 +149,25 @@ namespace utils {
         DATABASE    /**< Database output sink */
     };
 
+    /**
+     * @brief Where asynchronous messages get formatted
+     */
+    enum class FormatMode : uint8_t {
+        IMMEDIATE,  /**< Format on the caller's thread before enqueueing */
+        DEFERRED    /**< Capture format string and arguments, format on the logging thread */
+    };
+
+    /**
+     * @brief What a producer does when the async queue is at capacity
+     */
+    enum class OverflowPolicy : uint8_t {
+        BLOCK,              /**< Wait until the logging thread makes room */
+        DROP_NEWEST,        /**< Discard the event being logged */
+        DROP_OLDEST,        /**< Discard the oldest queued event to make room */
+        DROP_BELOW_LEVEL,   /**< Discard events below a level, wait for the others */
+        SAMPLE              /**< Wait for one event in every N, discard the rest */
+    };
+
     /**
      * @brief Get the ANSI color code for a given log level
      * @param level The log level to get the color for
@@ -108,34 +223,229 @@ namespace utils {
 
     /**
      * @brief Structure representing a log event
+     *
+     * Fixed-size record spanning four cache lines. The payload (the rendered message, preceded
+     * by the encoded arguments for a deferred message) is stored inline when it fits and
+     * otherwise in a block borrowed from BufferPool, so creating and moving events never
+     * touches the allocator in steady state.
      */
-    struct LogEvent {
+    struct alignas(64) LogEvent {
+        static constexpr std::size_t SIZE = 256;             /**< sizeof(LogEvent) */
+        static constexpr std::size_t INLINE_CAPACITY = 216;  /**< Payload bytes stored without an overflow buffer */
+
+        uint64_t timestamp;             /**< When the event occurred, nanoseconds since the Unix epoch */
+        uint32_t site;                  /**< CallSiteRegistry id of the call that created the event */
         LogLevel level;                 /**< Log level of the event */
-        std::string message;            /**< Log message content */
-        std::string timestamp;          /**< Timestamp of when the event occurred */
-        std::source_location location;  /**< Source code location information */
 
         /**
          * @brief Construct a new Log Event
+         * @param site Call site of the event, which also gives its level
+         * @param message Message content
+         */
+        LogEvent(const CallSite& site, std::string_view message) noexcept
+            : timestamp(getTimestamp()), site(site.id()), level(site.level) {
+            setMessage(message);
+        }
+
+        /**
+         * @brief Construct an event with an empty payload, to be filled through reserveArgs()
+         * @param site Call site of the event, which also gives its level
+         */
+        explicit LogEvent(const CallSite& site) noexcept
+            : timestamp(getTimestamp()), site(site.id()), level(site.level) {}
+
+        /**
+         * @brief Construct a new Log Event outside the LOG_* macros
+         *
+         * The location is looked up in CallSiteRegistry::intern(), which takes a lock on first use.
+         *
          * @param level Log level for the event
          * @param message Message content
          * @param location Source location information
          */
-        LogEvent(LogLevel level, std::string message, std::source_location location)
-            : level(level), message(message), timestamp(getTimestamp()), location(location) {}   
+        LogEvent(LogLevel level, std::string_view message, std::source_location location) noexcept
+            : LogEvent(CallSiteRegistry::intern(level, location, nullptr), message) {}
+
+        /**
+         * @brief Copy constructor, borrows a new overflow buffer if the payload needs one
+         */
+        LogEvent(const LogEvent& other) noexcept;
+
+        /**
+         * @brief Copy assignment operator
+         */
+        LogEvent& operator=(const LogEvent& other) noexcept;
+
+        /**
+         * @brief Move constructor, steals the overflow buffer
+         */
+        LogEvent(LogEvent&& other) noexcept
+            : timestamp(other.timestamp), site(other.site), level(other.level), pending(other.pending), captured(other.captured),
+              argsLength(other.argsLength), length(std::exchange(other.length, 0)), capacity(std::exchange(other.capacity, 0)),
+              overflow(std::exchange(other.overflow, nullptr)) {
+            if (overflow == nullptr) {
+                std::memcpy(inlineData, other.inlineData, length);
+            }
+        }
+
+        /**
+         * @brief Move assignment operator
+         */
+        LogEvent& operator=(LogEvent&& other) noexcept {
+            if (this != &other) {
+                releaseOverflow();
+                timestamp = other.timestamp;
+                site = other.site;
+                overflow = std::exchange(other.overflow, nullptr);
+                length = std::exchange(other.length, 0);
+                capacity = std::exchange(other.capacity, 0);
+                level = other.level;
+                argsLength = other.argsLength;
+                pending = other.pending;
+                captured = other.captured;
+                if (overflow == nullptr) {
+                    std::memcpy(inlineData, other.inlineData, length);
+                }
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Destructor, returns the overflow buffer to the pool
+         */
+        ~LogEvent() noexcept {
+            if (overflow != nullptr) [[unlikely]] {
+                releaseOverflow();
+            }
+        }
+
+        /**
+         * @brief The rendered message
+         * @return View of the payload, empty while the message is still deferred
+         */
+        [[nodiscard]] std::string_view message() const noexcept {
+            return pending ? std::string_view() : std::string_view(data() + argsLength, length - argsLength);
+        }
+
+        /**
+         * @brief The encoded arguments of a deferred message, see formatArgs.hpp
+         * @return View of the argument bytes, empty for pre-formatted messages
+         */
+        [[nodiscard]] std::string_view args() const noexcept { return {data(), argsLength}; }
+
+        /**
+         * @brief Description of the call that created the event: location and format string
+         */
+        [[nodiscard]] const CallSite& callSite() const noexcept { return CallSiteRegistry::get(site); }
+
+        /**
+         * @brief Format string the message is rendered from, see formatArgs.hpp
+         * @return The call site's format for events whose arguments were captured, a null view
+         *         for messages formatted before the event was created
+         */
+        [[nodiscard]] std::string_view format() const noexcept {
+            return captured ? callSite().format : std::string_view();
+        }
+
+        /**
+         * @brief Raw payload bytes: encoded arguments followed by the rendered message
+         */
+        [[nodiscard]] const char* data() const noexcept { return overflow ? overflow : inlineData; }
+
+        /**
+         * @brief Size of the payload in bytes
+         */
+        [[nodiscard]] std::size_t size() const noexcept { return length; }
+
+        /**
+         * @brief Memory held by the event: the record plus its overflow buffer, if any
+         */
+        [[nodiscard]] std::size_t footprint() const noexcept { return SIZE + capacity; }
+
+        /**
+         * @brief Replace the payload with a message, truncating it if no buffer is available
+         * @param message The new message
+         */
+        void setMessage(std::string_view message) noexcept {
+            argsLength = 0;
+            pending = false;
+            captured = false;
+            char* out = reserve(message.size());
+            if (out == nullptr) [[unlikely]] {
+                message = message.substr(0, INLINE_CAPACITY);
+                out = reserve(message.size());
+            }
+            std::memcpy(out, message.data(), message.size());
+        }
+
+        /**
+         * @brief Reserve the payload for encoded arguments and mark the message as deferred
+         * @param size Size of the encoded arguments in bytes, at most UINT16_MAX
+         * @return Writable storage for @p size bytes, or nullptr if no buffer could be borrowed
+         */
+        [[nodiscard]] char* reserveArgs(std::size_t size) noexcept {
+            char* out = reserve(size);
+            argsLength = out ? static_cast<uint16_t>(size) : 0;
+            pending = out != nullptr;
+            captured = out != nullptr;
+            return out;
+        }
+
+        /**
+         * @brief Store the rendered message of a deferred event after its encoded arguments
+         * @param message The rendered message, truncated if no buffer is available
+         */
+        void setRenderedMessage(std::string_view message) noexcept;
+
+        /**
+         * @brief Resize the payload and return a pointer to write it
+         * @param size Payload size in bytes
+         * @return Writable storage for @p size bytes, or nullptr if no buffer could be borrowed
+         */
+        [[nodiscard]] char* reserve(std::size_t size) noexcept {
+            if (size <= INLINE_CAPACITY) [[likely]] {
+                if (overflow != nullptr) [[unlikely]] releaseOverflow();
+                length = static_cast<uint32_t>(size);
+                return inlineData;
+            }
+            return reserveOverflow(size);
+        }
+
+        /**
+         * @brief Whether the message still has to be formatted from format and the payload
+         * @return true until the logging thread renders the message
+         */
+        [[nodiscard]] bool isDeferred() const noexcept { return pending; }
 
         private:
             /**
-             * @brief Get current timestamp as formatted string
-             * @return Formatted timestamp string
+             * @brief Borrow an overflow buffer large enough for @p size bytes
+             */
+            char* reserveOverflow(std::size_t size) noexcept;
+
+            /**
+             * @brief Give the overflow buffer back to the pool
              */
-            std::string getTimestamp() noexcept
+            void releaseOverflow() noexcept;
+
+            /**
+             * @brief Get current wall-clock time as a raw integer
+             * @return Nanoseconds since the Unix epoch
+             */
+            static uint64_t getTimestamp() noexcept
             {
-                auto now = std::chrono::system_clock::now();
-                auto in_time_t = std::chrono::system_clock::to_time_t(now);
-                std::stringstream ss;
-                ss << std::put_time(std::localtime(&in_time_t), "%Y-%m-%d %H:%M:%S");
-                return ss.str();
-            }; 
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count());
+            }
+
+            bool pending{false};                  /**< Whether the message still has to be rendered */
+            bool captured{false};                 /**< Whether the payload holds arguments for the site's format */
+            uint16_t argsLength{0};               /**< Bytes of encoded arguments at the start of the payload */
+            uint32_t length{0};                   /**< Payload size in bytes */
+            uint32_t capacity{0};                 /**< Capacity of overflow, 0 when inline */
+            char* overflow{nullptr};              /**< Pooled buffer holding a payload too large for inlineData */
+            char inlineData[INLINE_CAPACITY];     /**< Inline payload storage */
     };
+
+    static_assert(sizeof(LogEvent) == LogEvent::SIZE, "LogEvent must stay a whole number of cache lines");
 };
@@ -0,0 +1,194 @@
+#include "loggerCpp/binaryLogFormat.hpp"
+#include "loggerCpp/formatArgs.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    // Thrown internally when the file ends inside a record
+    struct EndOfFile {};
+}
+
+BinaryLogReader::BinaryLogReader(std::string_view path)
+    : file(std::string(path), std::ios::binary) {
+    if (!file.is_open()) {
+        throw std::runtime_error(fmt::format("Failed to open binary log: {}", path));
+    }
+    const int type = file.get();
+    if (type != static_cast<int>(BinaryLogFormat::Record::SESSION)) {
+        throw std::runtime_error(fmt::format("Not a binary log: {}", path));
+    }
+    try {
+        readSession();
+    } catch (const EndOfFile&) {
+        throw std::runtime_error(fmt::format("Not a binary log: {}", path));
+    }
+}
+
+bool BinaryLogReader::next(Event& event) {
+    try {
+        while (true) {
+            const int type = file.get();
+            if (type == std::char_traits<char>::eof()) {
+                return false;
+            }
+
+            switch (static_cast<BinaryLogFormat::Record>(type & 0xF0)) {
+                case BinaryLogFormat::Record::SESSION:
+                    readSession();
+                    break;
+                case BinaryLogFormat::Record::CALL_SITE:
+                    readCallSite();
+                    break;
+                case BinaryLogFormat::Record::EVENT: {
+                    const uint64_t id = readVarint();
+                    if (id >= callSites.size()) {
+                        throw std::runtime_error(fmt::format("Unknown call site {} in binary log", id));
+                    }
+                    lastTimestamp += static_cast<uint64_t>(BinaryLogFormat::unzigzag(readVarint()));
+                    args.resize(readVarint());
+                    readBytes(args.data(), args.size());
+
+                    event.level = static_cast<utils::LogLevel>(type & 0x0F);
+                    event.timestamp = lastTimestamp;
+                    event.site = &callSites[id];
+                    renderMessage(*event.site);
+                    event.message = std::string_view(message.data(), message.size());
+                    return true;
+                }
+                default:
+                    throw std::runtime_error(fmt::format("Unknown record type {:#x} in binary log", type));
+            }
+        }
+    } catch (const EndOfFile&) {
+        cutShort = true;
+        return false;
+    }
+}
+
+uint64_t BinaryLogReader::readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int byte = file.get();
+        if (byte == std::char_traits<char>::eof()) throw EndOfFile{};
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return value;
+    }
+    throw std::runtime_error("Malformed varint in binary log");
+}
+
+void BinaryLogReader::readString(std::string& out) {
+    out.resize(readVarint());
+    readBytes(out.data(), out.size());
+}
+
+void BinaryLogReader::readBytes(char* out, std::size_t size) {
+    if (!file.read(out, static_cast<std::streamsize>(size))) throw EndOfFile{};
+}
+
+void BinaryLogReader::readSession() {
+    char magic[sizeof(BinaryLogFormat::MAGIC) + 1];
+    readBytes(magic, sizeof(magic));
+    if (std::memcmp(magic, BinaryLogFormat::MAGIC, sizeof(BinaryLogFormat::MAGIC)) != 0) {
+        throw std::runtime_error("Bad session header in binary log");
+    }
+    if (static_cast<uint8_t>(magic[sizeof(BinaryLogFormat::MAGIC)]) != BinaryLogFormat::VERSION) {
+        throw std::runtime_error(fmt::format("Unsupported binary log version {}", static_cast<int>(magic[sizeof(BinaryLogFormat::MAGIC)])));
+    }
+    callSites.clear();
+    lastTimestamp = 0;
+}
+
+void BinaryLogReader::readCallSite() {
+    const uint64_t id = readVarint();
+    if (id != callSites.size()) {
+        throw std::runtime_error(fmt::format("Out of order call site {} in binary log", id));
+    }
+    CallSite site;
+    site.line = static_cast<uint32_t>(readVarint());
+    site.column = static_cast<uint32_t>(readVarint());
+    site.preformatted = (readVarint() & BinaryLogFormat::PREFORMATTED) != 0;
+    readString(site.file);
+    readString(site.function);
+    readString(site.format);
+    callSites.push_back(std::move(site));
+}
+
+void BinaryLogReader::renderMessage(const CallSite& site) {
+    message.clear();
+    store.clear();
+
+    const char* in = args.data();
+    const char* end = in + args.size();
+    auto varint = [&]() {
+        uint64_t value = 0;
+        for (int shift = 0; in < end && shift < 64; shift += 7) {
+            const auto byte = static_cast<uint8_t>(*in++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        throw std::runtime_error("Malformed event arguments in binary log");
+    };
+    auto bytes = [&](std::size_t size) {
+        if (static_cast<std::size_t>(end - in) < size) throw std::runtime_error("Malformed event arguments in binary log");
+        const char* at = in;
+        in += size;
+        return at;
+    };
+
+    // A FIELD tag names the value after it, which is printed behind the message instead of formatted
+    fields.clear();
+    std::string_view fieldKey;
+    bool inField = false;
+    auto push = [&](const auto& value) {
+        if (inField) {
+            fmt::format_to(fmt::appender(fields), " {}={}", fieldKey, value);
+            inField = false;
+        } else {
+            store.push_back(value);
+        }
+    };
+
+    while (in < end) {
+        const auto tag = static_cast<utils::ArgTag>(*in++);
+        switch (tag) {
+            case utils::ArgTag::INT: push(BinaryLogFormat::unzigzag(varint())); break;
+            case utils::ArgTag::UINT: push(varint()); break;
+            case utils::ArgTag::FLOAT: { float v; std::memcpy(&v, bytes(sizeof(v)), sizeof(v)); push(v); break; }
+            case utils::ArgTag::DOUBLE: { double v; std::memcpy(&v, bytes(sizeof(v)), sizeof(v)); push(v); break; }
+            case utils::ArgTag::BOOL: push(*bytes(1) != 0); break;
+            case utils::ArgTag::CHAR: push(*bytes(1)); break;
+            case utils::ArgTag::POINTER: push(reinterpret_cast<const void*>(static_cast<uintptr_t>(varint()))); break;
+            case utils::ArgTag::STRING: {
+                const auto size = varint();
+                const char* text = bytes(size);
+                if (site.preformatted && !inField) {
+                    message.append(text, text + size);
+                } else {
+                    push(fmt::string_view(text, size));
+                }
+                break;
+            }
+            case utils::ArgTag::FIELD: {
+                const auto size = varint();
+                const char* key = bytes(size);
+                fieldKey = std::string_view(key, size);
+                inField = true;
+                break;
+            }
+            default:
+                throw std::runtime_error(fmt::format("Unknown argument tag {} in binary log", static_cast<int>(tag)));
+        }
+    }
+
+    if (site.preformatted) {
+        return;
+    }
+    try {
+        fmt::vformat_to(fmt::appender(message), fmt::string_view(site.format), store);
+    } catch (const fmt::format_error& e) {
+        message.clear();
+        fmt::format_to(fmt::appender(message), "[format error: {}] {}", e.what(), site.format);
+    }
+    message.append(fields);
+}
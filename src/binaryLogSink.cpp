@@ -0,0 +1,135 @@
+#include "loggerCpp/binaryLogSink.hpp"
+#include "loggerCpp/binaryLogFormat.hpp"
+#include "loggerCpp/formatArgs.hpp"
+
+BinaryLogSink::BinaryLogSink(std::string_view fileName, const FileFlushPolicy& policy)
+    : policy(policy), lastFlush(std::chrono::steady_clock::now()) {
+    // Buffering is done in buffer, so each flush is a single write. Must precede open() to take effect
+    file.rdbuf()->pubsetbuf(nullptr, 0);
+    file.open(std::string(fileName), std::ios::app | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(fmt::format("Failed to open log file: {}", fileName));
+    }
+    buffer.reserve(this->policy.bufferSize);
+
+    buffer.push_back(static_cast<char>(BinaryLogFormat::Record::SESSION));
+    buffer.append(std::begin(BinaryLogFormat::MAGIC), std::end(BinaryLogFormat::MAGIC));
+    buffer.push_back(static_cast<char>(BinaryLogFormat::VERSION));
+}
+
+BinaryLogSink::~BinaryLogSink() noexcept {
+    writeBuffer();
+}
+
+void BinaryLogSink::write(const utils::LogEvent& event) {
+    writeBatch({&event, 1});
+}
+
+void BinaryLogSink::writeBatch(std::span<const utils::LogEvent> events) {
+    bool urgent = false;
+    for (const auto& event : events) {
+        appendEvent(event);
+        urgent |= event.level >= policy.flushLevel;
+        if (buffer.size() >= policy.bufferSize) [[unlikely]] {
+            writeBuffer();
+        }
+    }
+
+    if (urgent || std::chrono::steady_clock::now() - lastFlush >= policy.interval) {
+        writeBuffer();
+    }
+}
+
+void BinaryLogSink::flush() {
+    writeBuffer();
+}
+
+void BinaryLogSink::appendEvent(const utils::LogEvent& event) {
+    const uint32_t id = callSiteId(event);
+    encodeArgs(event);
+
+    buffer.push_back(static_cast<char>(static_cast<uint8_t>(BinaryLogFormat::Record::EVENT) | static_cast<uint8_t>(event.level)));
+    BinaryLogFormat::putVarint(buffer, id);
+    BinaryLogFormat::putVarint(buffer, BinaryLogFormat::zigzag(static_cast<int64_t>(event.timestamp - lastTimestamp)));
+    BinaryLogFormat::putVarint(buffer, args.size());
+    buffer.append(args.data(), args.data() + args.size());
+    lastTimestamp = event.timestamp;
+}
+
+uint32_t BinaryLogSink::callSiteId(const utils::LogEvent& event) {
+    // A site logs both captured and preformatted events (e.g. a deferred call that fell back
+    // to the caller's thread), and each needs its own dictionary entry
+    const std::string_view format = event.format();
+    const bool preformatted = format.data() == nullptr;
+    const std::size_t slot = static_cast<std::size_t>(event.site) * 2 + preformatted;
+    if (slot >= callSites.size()) [[unlikely]] {
+        callSites.resize(slot + 1, NOT_WRITTEN);
+    }
+    if (callSites[slot] == NOT_WRITTEN) {
+        const utils::CallSite& site = event.callSite();
+        callSites[slot] = nextCallSite++;
+        buffer.push_back(static_cast<char>(BinaryLogFormat::Record::CALL_SITE));
+        BinaryLogFormat::putVarint(buffer, callSites[slot]);
+        BinaryLogFormat::putVarint(buffer, site.line);
+        BinaryLogFormat::putVarint(buffer, site.column);
+        BinaryLogFormat::putVarint(buffer, preformatted ? BinaryLogFormat::PREFORMATTED : 0);
+        BinaryLogFormat::putString(buffer, site.file);
+        BinaryLogFormat::putString(buffer, site.function);
+        BinaryLogFormat::putString(buffer, format);
+    }
+    return callSites[slot];
+}
+
+void BinaryLogSink::encodeArgs(const utils::LogEvent& event) {
+    args.clear();
+    if (event.format().data() == nullptr) {
+        args.push_back(static_cast<char>(utils::ArgTag::STRING));
+        BinaryLogFormat::putString(args, event.message());
+        return;
+    }
+
+    const auto putValue = [this](const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, int64_t>) {
+            args.push_back(static_cast<char>(utils::ArgTag::INT));
+            BinaryLogFormat::putVarint(args, BinaryLogFormat::zigzag(value));
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+            args.push_back(static_cast<char>(utils::ArgTag::UINT));
+            BinaryLogFormat::putVarint(args, value);
+        } else if constexpr (std::is_same_v<T, float>) {
+            args.push_back(static_cast<char>(utils::ArgTag::FLOAT));
+            args.append(reinterpret_cast<const char*>(&value), reinterpret_cast<const char*>(&value) + sizeof(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            const auto narrowed = static_cast<double>(value);
+            args.push_back(static_cast<char>(utils::ArgTag::DOUBLE));
+            args.append(reinterpret_cast<const char*>(&narrowed), reinterpret_cast<const char*>(&narrowed) + sizeof(narrowed));
+        } else if constexpr (std::is_same_v<T, bool>) {
+            args.push_back(static_cast<char>(utils::ArgTag::BOOL));
+            args.push_back(static_cast<char>(value));
+        } else if constexpr (std::is_same_v<T, char>) {
+            args.push_back(static_cast<char>(utils::ArgTag::CHAR));
+            args.push_back(value);
+        } else if constexpr (std::is_same_v<T, const void*>) {
+            args.push_back(static_cast<char>(utils::ArgTag::POINTER));
+            BinaryLogFormat::putVarint(args, reinterpret_cast<uintptr_t>(value));
+        } else {
+            args.push_back(static_cast<char>(utils::ArgTag::STRING));
+            BinaryLogFormat::putString(args, value);
+        }
+    };
+
+    utils::visitArgs(event.args(), putValue);
+    utils::visitFields(event.args(), [&](std::string_view key, const auto& value) {
+        args.push_back(static_cast<char>(utils::ArgTag::FIELD));
+        BinaryLogFormat::putString(args, key);
+        putValue(value);
+    });
+}
+
+void BinaryLogSink::writeBuffer() {
+    if (buffer.size() != 0) {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    lastFlush = std::chrono::steady_clock::now();
+}
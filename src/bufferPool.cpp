@@ -0,0 +1,32 @@
+#include "loggerCpp/bufferPool.hpp"
+#include "loggerCpp/ringBuffer.hpp"
+
+#include <new>
+
+namespace {
+    // Intentionally leaked: events may still release blocks during static destruction
+    RingBuffer<char*>& freeBlocks() noexcept {
+        static auto* blocks = new RingBuffer<char*>(utils::BufferPool::MAX_POOLED);
+        return *blocks;
+    }
+}
+
+char* utils::BufferPool::acquire(std::size_t size, std::size_t& capacity) noexcept {
+    if (size <= BLOCK_SIZE) [[likely]] {
+        capacity = BLOCK_SIZE;
+        if (auto block = freeBlocks().tryPop()) {
+            return *block;
+        }
+        return new (std::nothrow) char[BLOCK_SIZE];
+    }
+    capacity = size;
+    return new (std::nothrow) char[size];
+}
+
+void utils::BufferPool::release(char* buffer, std::size_t capacity) noexcept {
+    if (buffer == nullptr) return;
+    if (capacity == BLOCK_SIZE && freeBlocks().tryPush(std::move(buffer))) {
+        return;
+    }
+    delete[] buffer;
+}
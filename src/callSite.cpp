@@ -0,0 +1,101 @@
+#include "loggerCpp/callSite.hpp"
+#include "loggerCpp/utils.hpp"
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace {
+    struct InternKey {
+        const char* file;
+        const char* function;
+        uint32_t line;
+        uint32_t column;
+        utils::LogLevel level;
+        const char* format;
+
+        bool operator==(const InternKey&) const noexcept = default;
+    };
+
+    struct InternHash {
+        std::size_t operator()(const InternKey& key) const noexcept {
+            std::size_t hash = std::hash<const void*>{}(key.file);
+            hash = hash * 31 + std::hash<const void*>{}(key.function);
+            hash = hash * 31 + key.line;
+            hash = hash * 31 + key.column;
+            hash = hash * 31 + static_cast<std::size_t>(key.level);
+            return hash * 31 + std::hash<const void*>{}(key.format);
+        }
+    };
+
+    // Serializes registration; lookups by id do not take it
+    std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::atomic<uint32_t> nextId{1};
+}
+
+const utils::CallSite utils::CallSiteRegistry::UNKNOWN{utils::LogLevel::NONE, std::source_location(), {}};
+const utils::CallSite* utils::CallSiteRegistry::firstChunk[CHUNK_SIZE]{&UNKNOWN};
+const utils::CallSite** utils::CallSiteRegistry::chunks[MAX_CHUNKS]{firstChunk};
+
+uint32_t utils::CallSiteRegistry::add(const CallSite& site) noexcept {
+    std::lock_guard lock(registryMutex());
+    return addLocked(site);
+}
+
+uint32_t utils::CallSiteRegistry::addLocked(const CallSite& site) noexcept {
+    if (&site == &UNKNOWN) return 0;
+    // Another thread may have registered the site while this one waited for the mutex
+    if (const uint32_t id = site.slot.load(std::memory_order_relaxed); id != CallSite::UNREGISTERED) {
+        return id;
+    }
+
+    const uint32_t id = nextId.load(std::memory_order_relaxed);
+    const std::size_t chunk = id / CHUNK_SIZE;
+    if (chunk >= MAX_CHUNKS) [[unlikely]] return 0;
+    if (chunks[chunk] == nullptr) {
+        chunks[chunk] = new (std::nothrow) const CallSite*[CHUNK_SIZE]{};
+        if (chunks[chunk] == nullptr) [[unlikely]] return 0;
+    }
+    chunks[chunk][id % CHUNK_SIZE] = &site;
+    nextId.store(id + 1, std::memory_order_relaxed);
+    site.slot.store(id, std::memory_order_release);
+    return id;
+}
+
+const utils::CallSite& utils::CallSiteRegistry::intern(LogLevel level, const std::source_location& location, const char* format) noexcept {
+    static std::unordered_map<InternKey, const CallSite*, InternHash> sites;
+    static std::deque<CallSite> storage;    // Never moves its elements
+    // Sites are never removed, so each thread remembers the ones it used without the mutex
+    thread_local std::unordered_map<InternKey, const CallSite*, InternHash> seen;
+
+    const InternKey key{location.file_name(), location.function_name(), location.line(), location.column(), level, format};
+    try {
+        if (const auto found = seen.find(key); found != seen.end()) return *found->second;
+
+        std::unique_lock lock(registryMutex());
+        const CallSite* site = nullptr;
+        if (const auto found = sites.find(key); found != sites.end()) {
+            site = found->second;
+        } else {
+            site = &storage.emplace_back(level, location, format ? std::string_view(format) : std::string_view());
+            sites.emplace(key, site);
+            addLocked(*site);
+        }
+        lock.unlock();
+
+        seen.emplace(key, site);
+        return *site;
+    } catch (...) {
+        return UNKNOWN;
+    }
+}
+
+std::size_t utils::CallSiteRegistry::size() noexcept {
+    return nextId.load(std::memory_order_relaxed);
+}
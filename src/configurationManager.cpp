@@ -3,13 +3,550 @@
 #include "loggerCpp/fileLogSink.hpp"
 #include "loggerCpp/dataBaseLogSink.hpp"
 #include "loggerCpp/networkLogSink.hpp"
+#include "loggerCpp/mmapFileLogSink.hpp"
+#include "loggerCpp/binaryLogSink.hpp"
+#include "loggerCpp/jsonLogSink.hpp"
+#include "loggerCpp/isolatedLogSink.hpp"
+#include "loggerCpp/logger.hpp"
 #ifdef __unix__
 #include "loggerCpp/sysLogSink.hpp"
 #endif
 
+#ifdef LOGGERCPP_HAS_JSON_CONFIG
+#include <nlohmann/json.hpp>
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
+/**
+ * @brief A configuration file: the sinks it created and the thread reloading it
+ */
+class ConfigurationManager::ConfigFile {
+public:
+    explicit ConfigFile(std::filesystem::path path) : path(std::move(path)) {}
+
+    ~ConfigFile() noexcept { stopWatching(); }
+
+    ConfigFile(const ConfigFile&) = delete;
+    ConfigFile& operator=(const ConfigFile&) = delete;
+
+    [[nodiscard]] const std::filesystem::path& file() const noexcept { return path; }
+
+    /**
+     * @brief Reads, validates and applies the file, see ConfigurationManager::loadConfigFile()
+     */
+    void apply();
+
+    /**
+     * @brief Starts the thread reloading the file when it changes
+     */
+    void watch();
+
+    /**
+     * @brief Stops and joins the watcher thread, if any
+     */
+    void stopWatching() noexcept;
+
+private:
+    /**
+     * @brief Body of the watcher thread
+     */
+    void watchLoop(std::stop_token stop) noexcept;
+
+    /**
+     * @brief Routes of the applied file, leaving out the sinks of the given keys
+     */
+    [[nodiscard]] std::vector<SinkRoute> routesWithout(const std::vector<std::string>& keys) const;
+
+    /**
+     * @brief Unroutes and destroys sinks of the applied file, so their files are closed
+     *
+     * Waits up to RELEASE_TIMEOUT for the engine to finish a batch it is writing to them.
+     *
+     * @param keys Descriptions of the sinks
+     * @throws std::runtime_error If a sink is still in use; its routes are restored
+     */
+    void releaseSinks(const std::vector<std::string>& keys);
+
+    static constexpr std::chrono::seconds RELEASE_TIMEOUT{1};   /**< Longest wait for a released sink to be unused */
+
+    std::filesystem::path path;                             /**< The configuration file */
+    std::mutex applyMutex;                                  /**< Serializes apply() between callers and the watcher */
+    std::map<std::string, std::shared_ptr<LogSink>> sinks;  /**< Sinks of the applied file, by description */
+    std::vector<std::pair<std::string, utils::LevelMask>> routes;   /**< Description and levels of each applied entry */
+    std::vector<Logger*> loggers;                           /**< Loggers given a level by the applied file */
+    int inotifyFd{-1};                                      /**< Watches the file's directory */
+    int wakeFd{-1};                                         /**< eventfd waking the watcher to stop */
+    std::jthread watcher;                                   /**< Reloads the file on change */
+};
+
+namespace {
+#ifdef LOGGERCPP_HAS_JSON_CONFIG
+    using nlohmann::json;
+
+    /**
+     * @brief A sink entry of the file
+     */
+    struct SinkConfig {
+        std::string key;            // Description without the levels, identifies the sink across reloads
+        utils::LevelMask levels;    // Levels routed to it
+        json description;           // The entry, without the levels
+    };
+
+    /**
+     * @brief Settings of the file; top-level keys left out are not set
+     */
+    struct Config {
+        std::optional<utils::LogLevel> level;
+        std::optional<bool> async;
+        std::optional<utils::FormatMode> formatMode;
+        std::optional<QueuePolicy> queue;
+        std::vector<SinkConfig> sinks;
+        std::map<std::string, utils::LogLevel> loggers;
+    };
+
+    [[noreturn]] void invalid(std::string_view what) {
+        throw std::runtime_error(std::string(what));
+    }
+
+    // A misspelt option is rejected rather than silently ignored
+    void checkKeys(const json& object, std::string_view where, const std::vector<std::string_view>& allowed) {
+        if (!object.is_object()) invalid(fmt::format("{} must be an object", where));
+        for (const auto& [key, value] : object.items()) {
+            if (std::find(allowed.begin(), allowed.end(), key) == allowed.end()) {
+                invalid(fmt::format("unknown key \"{}\" in {}", key, where));
+            }
+        }
+    }
+
+    utils::LogLevel parseLevel(const json& value) {
+        const std::string text = value.get<std::string>();
+        if (text == "NONE") return utils::LogLevel::NONE;
+        const utils::LogLevel level = utils::stringToLogLevel(text);
+        if (level == utils::LogLevel::NONE) invalid(fmt::format("unknown level \"{}\"", text));
+        return level;
+    }
+
+    template<typename T>
+    T get(const json& object, const char* key, T fallback) {
+        const auto it = object.find(key);
+        return it == object.end() ? fallback : it->get<T>();
+    }
+
+    std::chrono::milliseconds getMilliseconds(const json& object, const char* key, std::chrono::milliseconds fallback) {
+        return std::chrono::milliseconds(get<int64_t>(object, key, fallback.count()));
+    }
+
+    utils::OverflowPolicy parseOverflow(const json& value) {
+        const std::string text = value.get<std::string>();
+        if (text == "BLOCK") return utils::OverflowPolicy::BLOCK;
+        if (text == "DROP_NEWEST") return utils::OverflowPolicy::DROP_NEWEST;
+        if (text == "DROP_OLDEST") return utils::OverflowPolicy::DROP_OLDEST;
+        if (text == "DROP_BELOW_LEVEL") return utils::OverflowPolicy::DROP_BELOW_LEVEL;
+        if (text == "SAMPLE") return utils::OverflowPolicy::SAMPLE;
+        invalid(fmt::format("unknown overflow policy \"{}\"", text));
+    }
+
+    QueuePolicy parseQueue(const json& object) {
+        checkKeys(object, "queue", {"capacity", "maxBytes", "overflow", "dropBelow", "sampleRate", "reportIntervalMs"});
+        QueuePolicy policy;
+        policy.capacity = get<std::size_t>(object, "capacity", policy.capacity);
+        policy.maxBytes = get<std::size_t>(object, "maxBytes", policy.maxBytes);
+        if (object.contains("overflow")) policy.overflow = parseOverflow(object["overflow"]);
+        if (object.contains("dropBelow")) policy.dropBelow = parseLevel(object["dropBelow"]);
+        policy.sampleRate = get<uint32_t>(object, "sampleRate", policy.sampleRate);
+        policy.reportInterval = getMilliseconds(object, "reportIntervalMs", policy.reportInterval);
+        return policy;
+    }
+
+    FileFlushPolicy parseFlush(const json& sink) {
+        FileFlushPolicy policy;
+        if (!sink.contains("flush")) return policy;
+        const json& object = sink["flush"];
+        checkKeys(object, "flush", {"bufferBytes", "intervalMs", "level"});
+        policy.bufferSize = get<std::size_t>(object, "bufferBytes", policy.bufferSize);
+        policy.interval = getMilliseconds(object, "intervalMs", policy.interval);
+        if (object.contains("level")) policy.flushLevel = parseLevel(object["level"]);
+        return policy;
+    }
+
+    // Options accepted by each sink type, besides "type", "level", "levels" and "isolated"
+    const std::map<std::string_view, std::vector<std::string_view>>& sinkOptions() {
+        static const std::map<std::string_view, std::vector<std::string_view>> options{
+            {"console", {"type", "level", "levels", "isolated"}},
+            {"file", {"type", "level", "levels", "isolated", "path", "flush", "rotation", "index"}},
+            {"mmap", {"type", "level", "levels", "isolated", "path", "segmentBytes", "maxSegments"}},
+            {"binary", {"type", "level", "levels", "isolated", "path", "flush"}},
+            {"json", {"type", "level", "levels", "isolated", "path", "flush"}},
+            {"network", {"type", "level", "levels", "isolated", "url", "format", "appName", "facility", "lingerMs",
+                         "batchBytes", "maxPendingBytes", "reconnectMinMs", "reconnectMaxMs", "closeTimeoutMs"}},
+            {"database", {"type", "level", "levels", "isolated", "path", "batchRows", "commitIntervalMs"}},
+            {"syslog", {"type", "level", "levels", "isolated", "ident", "facility"}},
+        };
+        return options;
+    }
+
+    SinkConfig parseSink(const json& entry, std::size_t index) {
+        const std::string where = fmt::format("sinks[{}]", index);
+        if (!entry.is_object() || !entry.contains("type")) invalid(fmt::format("{} needs a \"type\"", where));
+        const std::string type = entry["type"].get<std::string>();
+        const auto options = sinkOptions().find(type);
+        if (options == sinkOptions().end()) invalid(fmt::format("{}: unknown sink type \"{}\"", where, type));
+        checkKeys(entry, where, options->second);
+
+        SinkConfig sink{{}, utils::levelsFrom(utils::LogLevel::TRACE), entry};
+        if (entry.contains("level") && entry.contains("levels")) {
+            invalid(fmt::format("{}: \"level\" and \"levels\" are exclusive", where));
+        }
+        if (entry.contains("level")) {
+            sink.levels = utils::levelsFrom(parseLevel(entry["level"]));
+        } else if (entry.contains("levels")) {
+            sink.levels = 0;
+            for (const json& level : entry["levels"]) {
+                sink.levels |= utils::levelBit(parseLevel(level));
+            }
+        }
+        sink.description.erase("level");
+        sink.description.erase("levels");
+        sink.key = sink.description.dump();
+        return sink;
+    }
+
+    Config parseConfig(const std::string& text) {
+        const json root = json::parse(text);
+        checkKeys(root, "the configuration", {"level", "async", "formatMode", "queue", "sinks", "loggers"});
+
+        Config config;
+        if (root.contains("level")) config.level = parseLevel(root["level"]);
+        if (root.contains("async")) config.async = root["async"].get<bool>();
+        if (root.contains("formatMode")) {
+            const std::string mode = root["formatMode"].get<std::string>();
+            if (mode == "DEFERRED") config.formatMode = utils::FormatMode::DEFERRED;
+            else if (mode == "IMMEDIATE") config.formatMode = utils::FormatMode::IMMEDIATE;
+            else invalid(fmt::format("unknown format mode \"{}\"", mode));
+        }
+        if (root.contains("queue")) config.queue = parseQueue(root["queue"]);
+        if (root.contains("sinks")) {
+            if (!root["sinks"].is_array()) invalid("\"sinks\" must be an array");
+            for (std::size_t i = 0; i < root["sinks"].size(); ++i) {
+                config.sinks.push_back(parseSink(root["sinks"][i], i));
+            }
+        }
+        if (root.contains("loggers")) {
+            if (!root["loggers"].is_object()) invalid("\"loggers\" must be an object of logger names to levels");
+            for (const auto& [name, level] : root["loggers"].items()) {
+                config.loggers[name] = parseLevel(level);
+            }
+        }
+        return config;
+    }
+
+    // File a sink writes to, normalised so two spellings of one path compare equal; empty for none
+    std::string sinkPath(const json& sink) {
+        const auto path = sink.find("path");
+        if (path == sink.end() || !path->is_string()) return {};
+        std::error_code ec;
+        const std::filesystem::path absolute = std::filesystem::absolute(path->get<std::string>(), ec);
+        return (ec ? std::filesystem::path(path->get<std::string>()) : absolute).lexically_normal().string();
+    }
+
+    std::shared_ptr<LogSink> makeSink(const json& sink) {
+        const std::string type = sink["type"].get<std::string>();
+        std::shared_ptr<LogSink> created;
+        if (type == "console") {
+            created = std::make_shared<ConsoleLogSink>();
+        } else if (type == "file") {
+            FileRotationPolicy rotation;
+            if (sink.contains("rotation")) {
+                const json& object = sink["rotation"];
+                checkKeys(object, "rotation", {"maxBytes", "intervalSeconds", "maxFiles"});
+                rotation.maxBytes = get<std::size_t>(object, "maxBytes", rotation.maxBytes);
+                rotation.interval = std::chrono::seconds(get<int64_t>(object, "intervalSeconds", rotation.interval.count()));
+                rotation.maxFiles = get<std::size_t>(object, "maxFiles", rotation.maxFiles);
+            }
+            FileIndexPolicy index;
+            if (sink.contains("index")) {
+                checkKeys(sink["index"], "index", {"blockBytes"});
+                index.blockBytes = get<std::size_t>(sink["index"], "blockBytes", index.blockBytes);
+            }
+            created = std::make_shared<FileLogSink>(sink.at("path").get<std::string>(), parseFlush(sink), rotation, index);
+        } else if (type == "mmap") {
+            MmapSegmentPolicy policy;
+            policy.segmentSize = get<std::size_t>(sink, "segmentBytes", policy.segmentSize);
+            policy.maxSegments = get<std::size_t>(sink, "maxSegments", policy.maxSegments);
+            created = std::make_shared<MmapFileLogSink>(sink.at("path").get<std::string>(), policy);
+        } else if (type == "binary") {
+            created = std::make_shared<BinaryLogSink>(sink.at("path").get<std::string>(), parseFlush(sink));
+        } else if (type == "json") {
+            created = std::make_shared<JsonLogSink>(sink.at("path").get<std::string>(), parseFlush(sink));
+        } else if (type == "network") {
+            NetworkSinkOptions options;
+            const std::string format = get<std::string>(sink, "format", "SYSLOG");
+            if (format == "JSON_LINES") options.format = NetworkFormat::JSON_LINES;
+            else if (format != "SYSLOG") invalid(fmt::format("unknown network format \"{}\"", format));
+            options.appName = get<std::string>(sink, "appName", options.appName);
+            options.facility = get<int>(sink, "facility", options.facility);
+            options.linger = getMilliseconds(sink, "lingerMs", options.linger);
+            options.batchBytes = get<std::size_t>(sink, "batchBytes", options.batchBytes);
+            options.maxPendingBytes = get<std::size_t>(sink, "maxPendingBytes", options.maxPendingBytes);
+            options.reconnectMin = getMilliseconds(sink, "reconnectMinMs", options.reconnectMin);
+            options.reconnectMax = getMilliseconds(sink, "reconnectMaxMs", options.reconnectMax);
+            options.closeTimeout = getMilliseconds(sink, "closeTimeoutMs", options.closeTimeout);
+            created = std::make_shared<NetworkLogSink>(sink.at("url").get<std::string>(), options);
+        } else if (type == "database") {
+            DataBaseSinkOptions options;
+            options.batchRows = get<std::size_t>(sink, "batchRows", options.batchRows);
+            options.commitInterval = getMilliseconds(sink, "commitIntervalMs", options.commitInterval);
+            created = std::make_shared<DataBaseLogSink>(sink.at("path").get<std::string>(), options);
+        } else if (type == "syslog") {
+#ifdef __unix__
+            created = std::make_shared<SysLogSink>(get<std::string>(sink, "ident", "loggerCpp"), get<int>(sink, "facility", LOG_USER));
+#else
+            invalid("syslog sinks are only available on Unix");
+#endif
+        }
+
+        if (sink.contains("isolated") && !(sink["isolated"].is_boolean() && !sink["isolated"].get<bool>())) {
+            IsolatedSinkOptions options;
+            if (sink["isolated"].is_object()) {
+                checkKeys(sink["isolated"], "isolated", {"capacity", "batchSize"});
+                options.capacity = get<std::size_t>(sink["isolated"], "capacity", options.capacity);
+                options.batchSize = get<std::size_t>(sink["isolated"], "batchSize", options.batchSize);
+            }
+            created = std::make_shared<IsolatedLogSink>(std::move(created), options);
+        }
+        return created;
+    }
+#endif
+
+    std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error(fmt::format("cannot open {}: {}", path.string(), std::strerror(errno)));
+        }
+        std::ostringstream text;
+        text << file.rdbuf();
+        return std::move(text).str();
+    }
+}
+
+void ConfigurationManager::ConfigFile::apply() {
+#ifdef LOGGERCPP_HAS_JSON_CONFIG
+    std::lock_guard lock(applyMutex);
+    const std::string text = readFile(path);
+
+    // Everything that can fail happens before the engine is touched, except closing sinks
+    // whose files a new sink takes over
+    Config config;
+    std::map<std::string, std::shared_ptr<LogSink>> nextSinks;
+    std::vector<SinkRoute> nextRoutes;
+    std::vector<std::pair<std::string, utils::LevelMask>> nextRouteKeys;
+    std::vector<Logger*> nextLoggers;
+    std::vector<std::string> released;
+    try {
+        config = parseConfig(text);
+
+        // A sink whose options changed is a new instance; two sinks appending to and rotating
+        // one file corrupt it, so the old one is closed before the new one opens the file
+        std::vector<std::string> newPaths;
+        std::vector<std::string> replaced;
+        for (const SinkConfig& sink : config.sinks) {
+            if (!sinks.contains(sink.key)) {
+                if (std::string sinkFile = sinkPath(sink.description); !sinkFile.empty()) newPaths.push_back(std::move(sinkFile));
+            }
+        }
+        for (const auto& [key, sink] : sinks) {
+            const bool kept = std::any_of(config.sinks.begin(), config.sinks.end(), [&key](const SinkConfig& next) { return next.key == key; });
+            if (!kept && std::find(newPaths.begin(), newPaths.end(), sinkPath(json::parse(key))) != newPaths.end()) {
+                replaced.push_back(key);
+            }
+        }
+        if (!replaced.empty()) {
+            releaseSinks(replaced);
+            released = std::move(replaced);
+        }
+
+        for (const SinkConfig& sink : config.sinks) {
+            std::shared_ptr<LogSink>& slot = nextSinks[sink.key];
+            if (!slot) {
+                const auto kept = sinks.find(sink.key);
+                slot = kept != sinks.end() ? kept->second : makeSink(sink.description);
+            }
+            nextRoutes.push_back({sink.levels, slot});
+            nextRouteKeys.emplace_back(sink.key, sink.levels);
+        }
+        for (const auto& [name, level] : config.loggers) {
+            nextLoggers.push_back(&Logger::get(name));
+        }
+    } catch (const std::exception& e) {
+        // Bring back the closed sinks, so a failed reload leaves the previous setup running
+        for (const std::string& key : released) {
+            try {
+                sinks[key] = makeSink(json::parse(key));
+            } catch (const std::exception&) {
+                sinks.erase(key);
+            }
+        }
+        if (!released.empty()) {
+            LoggingEngine::getInstance().setSinks(routesWithout({}));
+        }
+        throw std::runtime_error(fmt::format("{}: {}", path.string(), e.what()));
+    }
+
+    LoggingEngine& engine = LoggingEngine::getInstance();
+    if (config.queue) engine.setQueuePolicy(*config.queue);
+    if (config.formatMode) engine.setFormatMode(*config.formatMode);
+    engine.setSinks(std::move(nextRoutes));
+    if (config.level) engine.setLogLevel(*config.level);
+    // Loggers the file no longer lists inherit again
+    for (Logger* logger : loggers) {
+        if (std::find(nextLoggers.begin(), nextLoggers.end(), logger) == nextLoggers.end()) logger->resetLevel();
+    }
+    for (const auto& [name, level] : config.loggers) {
+        Logger::get(name).setLevel(level);
+    }
+    if (config.async) {
+        if (*config.async) engine.startAsync();
+        else engine.stopAsync();
+    }
+    // Sinks dropped from the file are released once the logging thread is done with them
+    sinks = std::move(nextSinks);
+    routes = std::move(nextRouteKeys);
+    loggers = std::move(nextLoggers);
+#else
+    throw std::runtime_error(fmt::format("cannot load {}: loggerCpp was built without nlohmann/json", path.string()));
+#endif
+}
+
+std::vector<SinkRoute> ConfigurationManager::ConfigFile::routesWithout(const std::vector<std::string>& keys) const {
+    std::vector<SinkRoute> result;
+    for (const auto& [key, levels] : routes) {
+        const auto sink = sinks.find(key);
+        if (sink != sinks.end() && std::find(keys.begin(), keys.end(), key) == keys.end()) {
+            result.push_back({levels, sink->second});
+        }
+    }
+    return result;
+}
+
+void ConfigurationManager::ConfigFile::releaseSinks(const std::vector<std::string>& keys) {
+    LoggingEngine& engine = LoggingEngine::getInstance();
+    engine.setSinks(routesWithout(keys));
+
+    // Unrouted, a sink is only held by a batch still being written to it, then by this map alone
+    const auto deadline = std::chrono::steady_clock::now() + RELEASE_TIMEOUT;
+    for (const std::string& key : keys) {
+        while (sinks.at(key).use_count() > 1) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                engine.setSinks(routesWithout({}));
+                throw std::runtime_error("a sink being replaced is still in use, not reloaded");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    for (const std::string& key : keys) {
+        sinks.erase(key);
+    }
+}
+
+void ConfigurationManager::ConfigFile::watch() {
+#ifdef __linux__
+    if (watcher.joinable()) return;
+
+    // Watch the directory: editors and deployment tools replace the file by renaming a new one over it
+    const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotifyFd < 0 || wakeFd < 0 || inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        const int error = errno;
+        stopWatching();
+        throw std::runtime_error(fmt::format("cannot watch {}: {}", path.string(), std::strerror(error)));
+    }
+    watcher = std::jthread([this](std::stop_token stop) { watchLoop(stop); });
+#else
+    throw std::runtime_error(fmt::format("cannot watch {}: only supported on Linux", path.string()));
+#endif
+}
+
+void ConfigurationManager::ConfigFile::stopWatching() noexcept {
+    if (watcher.joinable()) {
+        watcher.request_stop();
+        watcher.join();
+    }
+#ifdef __linux__
+    if (inotifyFd >= 0) ::close(inotifyFd);
+    if (wakeFd >= 0) ::close(wakeFd);
+#endif
+    inotifyFd = -1;
+    wakeFd = -1;
+}
+
+void ConfigurationManager::ConfigFile::watchLoop(std::stop_token stop) noexcept {
+#ifdef __linux__
+    std::stop_callback wake(stop, [this] {
+        const uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = ::write(wakeFd, &one, sizeof(one));
+    });
+
+    const std::string name = path.filename().string();
+    // Reads every pending event, telling whether one of them names the file
+    const auto drain = [this, &name] {
+        alignas(inotify_event) char events[4096];
+        bool changed = false;
+        ssize_t size;
+        while ((size = ::read(inotifyFd, events, sizeof(events))) > 0) {
+            for (const char* p = events; p < events + size;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(p);
+                changed |= event->len != 0 && name == event->name;
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        return changed;
+    };
+
+    while (!stop.stop_requested()) {
+        pollfd fds[2]{{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents != 0) break;
+        if (!drain()) continue;
+
+        // A save often comes as several events; let them settle and load once
+        pollfd wakeOnly{wakeFd, POLLIN, 0};
+        if (::poll(&wakeOnly, 1, 50) > 0) break;
+        drain();
+
+        // <syslog.h> has its own LOG_INFO, hence the underlying macro
+        try {
+            apply();
+            LOGGERCPP_LOG(utils::LogLevel::INFO, "Configuration reloaded from {}", path.string());
+        } catch (const std::exception& e) {
+            LOGGERCPP_LOG(utils::LogLevel::ERROR, "Configuration not reloaded, keeping the current one: {}", e.what());
+        }
+    }
+#endif
+}
+
 ConfigurationManager::ConfigurationManager() {
     LoggingEngine& logger = LoggingEngine::getInstance();
     #ifdef NDEBUG
@@ -24,6 +561,32 @@ ConfigurationManager::ConfigurationManager(const utils::LogLevel& logLevel) {
     logger.setLogLevel(logLevel);
 }
 
+ConfigurationManager::~ConfigurationManager() noexcept = default;
+
+ConfigurationManager::ConfigurationManager(ConfigurationManager&&) noexcept = default;
+
+ConfigurationManager& ConfigurationManager::operator=(ConfigurationManager&&) noexcept = default;
+
+void ConfigurationManager::loadConfigFile(const std::filesystem::path& path) {
+    if (configFile && configFile->file() == path) {
+        configFile->apply();
+        return;
+    }
+    // A new file replaces the previous one only once it has been applied
+    auto next = std::make_unique<ConfigFile>(path);
+    next->apply();
+    configFile = std::move(next);
+}
+
+void ConfigurationManager::watchConfigFile(const std::filesystem::path& path) {
+    loadConfigFile(path);
+    configFile->watch();
+}
+
+void ConfigurationManager::stopWatching() noexcept {
+    if (configFile) configFile->stopWatching();
+}
+
 void ConfigurationManager::applyConsoleSink(const utils::LogLevel& level) {
     LoggingEngine& logger = LoggingEngine::getInstance();
     logger.addSink(std::make_shared<ConsoleLogSink>(), level);
@@ -31,32 +594,22 @@ void ConfigurationManager::applyConsoleSink(const utils::LogLevel& level) {
 
 void ConfigurationManager::applyConsoleSink(const utils::LogLevel& level1, const utils::LogLevel& level2) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level1);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level2);
+    logger.addSink(std::make_shared<ConsoleLogSink>(), utils::levelBit(level1) | utils::levelBit(level2));
 }
 
 void ConfigurationManager::applyConsoleSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level1);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level2);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level3);
+    logger.addSink(std::make_shared<ConsoleLogSink>(), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3));
 }
 
 void ConfigurationManager::applyConsoleSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level1);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level2);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level3);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level4);
+    logger.addSink(std::make_shared<ConsoleLogSink>(), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4));
 }
 
 void ConfigurationManager::applyConsoleSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const utils::LogLevel& level5) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level1);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level2);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level3);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level4);
-    logger.addSink(std::make_shared<ConsoleLogSink>(), level5);
+    logger.addSink(std::make_shared<ConsoleLogSink>(), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4) | utils::levelBit(level5));
 }
 
 void ConfigurationManager::applyFileSink(const utils::LogLevel& level, const std::string_view& filename) {  
@@ -66,32 +619,22 @@ void ConfigurationManager::applyFileSink(const utils::LogLevel& level, const std
 
 void ConfigurationManager::applyFileSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const std::string_view& filename) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<FileLogSink>(filename), level1);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level2);
+    logger.addSink(std::make_shared<FileLogSink>(filename), utils::levelBit(level1) | utils::levelBit(level2));
 }
 
 void ConfigurationManager::applyFileSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const std::string_view& filename) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<FileLogSink>(filename), level1);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level2);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level3);
+    logger.addSink(std::make_shared<FileLogSink>(filename), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3));
 }
 
 void ConfigurationManager::applyFileSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const std::string_view& filename) {    
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<FileLogSink>(filename), level1);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level2);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level3);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level4);
+    logger.addSink(std::make_shared<FileLogSink>(filename), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4));
 }
 
 void ConfigurationManager::applyFileSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const utils::LogLevel& level5, const std::string_view& filename) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<FileLogSink>(filename), level1);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level2);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level3);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level4);
-    logger.addSink(std::make_shared<FileLogSink>(filename), level5);
+    logger.addSink(std::make_shared<FileLogSink>(filename), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4) | utils::levelBit(level5));
 }
 
 void ConfigurationManager::applyNetworkSink(const utils::LogLevel& level, const std::string_view& url) {
@@ -101,32 +644,22 @@ void ConfigurationManager::applyNetworkSink(const utils::LogLevel& level, const
 
 void ConfigurationManager::applyNetworkSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const std::string_view& url) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level1);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level2);
+    logger.addSink(std::make_shared<NetworkLogSink>(url), utils::levelBit(level1) | utils::levelBit(level2));
 }
 
 void ConfigurationManager::applyNetworkSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const std::string_view& url) { 
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level1);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level2);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level3);
+    logger.addSink(std::make_shared<NetworkLogSink>(url), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3));
 }
 
 void ConfigurationManager::applyNetworkSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const std::string_view& url) {          
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level1);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level2);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level3);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level4);
+    logger.addSink(std::make_shared<NetworkLogSink>(url), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4));
 }
 
 void ConfigurationManager::applyNetworkSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const utils::LogLevel& level5, const std::string_view& url) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level1);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level2);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level3);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level4);
-    logger.addSink(std::make_shared<NetworkLogSink>(url), level5);
+    logger.addSink(std::make_shared<NetworkLogSink>(url), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4) | utils::levelBit(level5));
 }
 
 void ConfigurationManager::applyDataBaseSink(const utils::LogLevel& level, const std::string_view& database) {
@@ -136,32 +669,22 @@ void ConfigurationManager::applyDataBaseSink(const utils::LogLevel& level, const
 
 void ConfigurationManager::applyDataBaseSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const std::string_view& database) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level1);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level2);
+    logger.addSink(std::make_shared<DataBaseLogSink>(database), utils::levelBit(level1) | utils::levelBit(level2));
 }
 
 void ConfigurationManager::applyDataBaseSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const std::string_view& database) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level1);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level2);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level3);
+    logger.addSink(std::make_shared<DataBaseLogSink>(database), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3));
 }
 
 void ConfigurationManager::applyDataBaseSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const std::string_view& database) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level1);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level2);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level3);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level4);
+    logger.addSink(std::make_shared<DataBaseLogSink>(database), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4));
 }
 
 void ConfigurationManager::applyDataBaseSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const utils::LogLevel& level5, const std::string_view& database) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level1);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level2);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level3);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level4);
-    logger.addSink(std::make_shared<DataBaseLogSink>(database), level5);
+    logger.addSink(std::make_shared<DataBaseLogSink>(database), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4) | utils::levelBit(level5));
 }
 
 #ifdef __unix__
@@ -172,31 +695,21 @@ void ConfigurationManager::applySysLogSink(const utils::LogLevel& level, const s
 
 void ConfigurationManager::applySysLogSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const std::string_view& ident) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<SysLogSink>(ident), level1);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level2);
+    logger.addSink(std::make_shared<SysLogSink>(ident), utils::levelBit(level1) | utils::levelBit(level2));
 }   
 
 void ConfigurationManager::applySysLogSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const std::string_view& ident) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<SysLogSink>(ident), level1);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level2);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level3);
+    logger.addSink(std::make_shared<SysLogSink>(ident), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3));
 }
 
 void ConfigurationManager::applySysLogSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const std::string_view& ident) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<SysLogSink>(ident), level1);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level2);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level3);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level4);
+    logger.addSink(std::make_shared<SysLogSink>(ident), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4));
 }
 
 void ConfigurationManager::applySysLogSink(const utils::LogLevel& level1, const utils::LogLevel& level2, const utils::LogLevel& level3, const utils::LogLevel& level4, const utils::LogLevel& level5, const std::string_view& ident) {
     LoggingEngine& logger = LoggingEngine::getInstance();
-    logger.addSink(std::make_shared<SysLogSink>(ident), level1);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level2);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level3);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level4);
-    logger.addSink(std::make_shared<SysLogSink>(ident), level5);
+    logger.addSink(std::make_shared<SysLogSink>(ident), utils::levelBit(level1) | utils::levelBit(level2) | utils::levelBit(level3) | utils::levelBit(level4) | utils::levelBit(level5));
 }
 #endif
\ No newline at end of file
@@ -1,18 +1,31 @@
 #include "loggerCpp/consoleLogSink.hpp"
+#include "loggerCpp/jsonEscape.hpp"
 
 #include <iostream>
-#include <format>
 
 void ConsoleLogSink::write(const utils::LogEvent& event) {
+    writeBatch({&event, 1});
+}
+
+void ConsoleLogSink::writeBatch(std::span<const utils::LogEvent> events) {
+    buffer.clear();
+    for (const auto& event : events) {
+        appendEvent(event);
+    }
+    std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+void ConsoleLogSink::appendEvent(const utils::LogEvent& event) {
     // Format and output log level, timestamp, message and location
-    std::cout << std::format("{}[{}]\n[{}] {}{} (function_name: {} row:{})\n",
+    fmt::format_to(fmt::appender(buffer), "{}[{}]\n[{}] {}",
         utils::getColorForLogLevel(event.level),
         utils::getLogLevelString(event.level),
-        event.timestamp,
-        COLOR_RESET,
-        event.message,
-        event.location.function_name(),
-        event.location.line()
+        timestampFormatter.format(event.timestamp),
+        COLOR_RESET
        );
-
-}
\ No newline at end of file
+    // The message may carry user input: keep its escape sequences away from the terminal
+    utils::appendSanitized(buffer, event.message());
+    buffer.append(locations.get(event.site, [](const utils::CallSite& site, std::string& text) {
+        text = fmt::format(" (function_name: {} row:{})\n", site.function, site.line);
+    }));
+}
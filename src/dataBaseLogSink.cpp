@@ -1,16 +1,197 @@
-
 #include "loggerCpp/dataBaseLogSink.hpp"
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef LOGGERCPP_HAS_SQLITE
+
+#include <sqlite3.h>
+
+namespace {
+    constexpr const char* SCHEMA =
+        "CREATE TABLE IF NOT EXISTS logs ("
+        "  id INTEGER PRIMARY KEY,"
+        "  timestamp INTEGER NOT NULL,"
+        "  level INTEGER NOT NULL,"
+        "  file TEXT,"
+        "  line INTEGER,"
+        "  function TEXT,"
+        "  message TEXT NOT NULL);"
+        "CREATE INDEX IF NOT EXISTS logs_timestamp ON logs(timestamp);"
+        "CREATE INDEX IF NOT EXISTS logs_level ON logs(level);";
+
+    constexpr const char* INSERT =
+        "INSERT INTO logs (timestamp, level, file, line, function, message) VALUES (?, ?, ?, ?, ?, ?)";
+
+    constexpr int BUSY_TIMEOUT_MS = 1000;   // How long a write waits for a reader holding a lock
+}
+
+DataBaseLogSink::DataBaseLogSink(std::string_view database, const DataBaseSinkOptions& options)
+    : options(options) {
+    this->options.batchRows = std::max<std::size_t>(this->options.batchRows, 1);
+
+    const std::string path(database);
+    // No SQLite mutex: the router never calls into one sink from two threads at once
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+        const std::string message = db != nullptr ? sqlite3_errmsg(db) : "out of memory";
+        sqlite3_close(db);
+        throw std::runtime_error(fmt::format("Failed to open log database {}: {}", path, message));
+    }
+
+    try {
+        sqlite3_busy_timeout(db, BUSY_TIMEOUT_MS);
+        // WAL lets readers query the log while it is written; NORMAL only syncs at checkpoints
+        execute("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;");
+        execute(SCHEMA);
+        for (auto [sql, statement] : {std::pair{INSERT, &insertStatement},
+                                      std::pair{"BEGIN", &beginStatement},
+                                      std::pair{"COMMIT", &commitStatement}}) {
+            if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, statement, nullptr) != SQLITE_OK) {
+                throw std::runtime_error(fmt::format("Failed to prepare log database statement: {}", sqlite3_errmsg(db)));
+            }
+        }
+    } catch (...) {
+        sqlite3_finalize(insertStatement);
+        sqlite3_finalize(beginStatement);
+        sqlite3_finalize(commitStatement);
+        sqlite3_close(db);
+        throw;
+    }
+}
+
+DataBaseLogSink::~DataBaseLogSink() noexcept {
+    try {
+        commit();
+    } catch (...) {
+        // Nowhere to report it; the rows of the open transaction are lost
+    }
+    sqlite3_finalize(insertStatement);
+    sqlite3_finalize(beginStatement);
+    sqlite3_finalize(commitStatement);
+    sqlite3_close(db);
+}
+
 void DataBaseLogSink::write(const utils::LogEvent& event) {
-    // TODO: Implement database logging
-    // This would connect to a database and insert log records
-    std::cerr << "Error: Database logging not implemented\n";
-    throw std::runtime_error("Database logging not implemented");
-}
-
-DataBaseLogSink::DataBaseLogSink(const std::string_view& database) {
-    // TODO: Implement database logging
-    // This would connect to a database and insert log records
-    std::cerr << "Error: Database logging not implemented\n";
-    throw std::runtime_error("Database logging not implemented");
-}
\ No newline at end of file
+    writeBatch({&event, 1});
+}
+
+void DataBaseLogSink::writeBatch(std::span<const utils::LogEvent> events) {
+    bool failed = false;
+    std::string commitError;
+    for (const auto& event : events) {
+        failed = !insert(event) || failed;
+        // After a failed commit the rest of the batch goes into the still open transaction;
+        // retrying on every row would wait out the busy timeout each time
+        if (openRows >= options.batchRows && commitError.empty()) {
+            try {
+                commit();
+            } catch (const std::runtime_error& e) {
+                commitError = e.what();
+            }
+        }
+    }
+    if (commitError.empty()) {
+        try {
+            commitIfDue();
+        } catch (const std::runtime_error& e) {
+            commitError = e.what();
+        }
+    }
+
+    if (failed && !commitError.empty()) {
+        throw std::runtime_error(fmt::format("Failed to insert log event: {}; {}", lastError, commitError));
+    }
+    if (failed) {
+        throw std::runtime_error(fmt::format("Failed to insert log event: {}", lastError));
+    }
+    if (!commitError.empty()) {
+        throw std::runtime_error(commitError);
+    }
+}
+
+void DataBaseLogSink::flush() {
+    commit();
+}
+
+void DataBaseLogSink::execute(const char* sql) {
+    char* error = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &error) != SQLITE_OK) {
+        const std::string message = error != nullptr ? error : sqlite3_errmsg(db);
+        sqlite3_free(error);
+        throw std::runtime_error(fmt::format("Log database error: {}", message));
+    }
+}
+
+bool DataBaseLogSink::insert(const utils::LogEvent& event) noexcept {
+    if (!inTransaction) {
+        const int result = sqlite3_step(beginStatement);
+        sqlite3_reset(beginStatement);
+        if (result != SQLITE_DONE) {
+            lastError = sqlite3_errmsg(db);
+            return false;
+        }
+        inTransaction = true;
+        transactionStart = std::chrono::steady_clock::now();
+    }
+
+    const std::string_view message = event.message();
+    // Bound as static: the event outlives the step below
+    sqlite3_bind_int64(insertStatement, 1, static_cast<sqlite3_int64>(event.timestamp));
+    sqlite3_bind_int(insertStatement, 2, static_cast<int>(event.level));
+    const utils::CallSite& site = event.callSite();
+    sqlite3_bind_text(insertStatement, 3, site.file, -1, SQLITE_STATIC);
+    sqlite3_bind_int64(insertStatement, 4, site.line);
+    sqlite3_bind_text(insertStatement, 5, site.function, -1, SQLITE_STATIC);
+    sqlite3_bind_text(insertStatement, 6, message.data(), static_cast<int>(message.size()), SQLITE_STATIC);
+
+    const int result = sqlite3_step(insertStatement);
+    sqlite3_reset(insertStatement);
+    if (result != SQLITE_DONE) {
+        lastError = sqlite3_errmsg(db);
+        return false;
+    }
+    ++openRows;
+    return true;
+}
+
+void DataBaseLogSink::commitIfDue() {
+    if (inTransaction && (openRows >= options.batchRows ||
+                          std::chrono::steady_clock::now() - transactionStart >= options.commitInterval)) {
+        commit();
+    }
+}
+
+void DataBaseLogSink::commit() {
+    if (!inTransaction) return;
+    const int result = sqlite3_step(commitStatement);
+    sqlite3_reset(commitStatement);
+    if (result != SQLITE_DONE) {
+        // A busy database keeps the transaction open for a later commit to retry; other errors roll it back
+        if (sqlite3_get_autocommit(db) != 0) {
+            inTransaction = false;
+            openRows = 0;
+        }
+        throw std::runtime_error(fmt::format("Failed to commit log events: {}", sqlite3_errmsg(db)));
+    }
+    inTransaction = false;
+    openRows = 0;
+}
+
+#else
+
+DataBaseLogSink::DataBaseLogSink(std::string_view database, const DataBaseSinkOptions& options)
+    : options(options) {
+    throw std::runtime_error(fmt::format("Cannot open log database {}: loggerCpp was built without SQLite", database));
+}
+
+DataBaseLogSink::~DataBaseLogSink() noexcept = default;
+
+void DataBaseLogSink::write(const utils::LogEvent&) {}
+
+void DataBaseLogSink::writeBatch(std::span<const utils::LogEvent>) {}
+
+void DataBaseLogSink::flush() {}
+
+#endif
@@ -0,0 +1,242 @@
+#include "loggerCpp/fileLogIndex.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+namespace {
+    constexpr std::size_t CHUNK_SIZE = 4 * 1024 * 1024;     // Read size for ranges no index entry covers
+
+    void putLittleEndian(char* out, uint64_t value, std::size_t bytes) noexcept {
+        for (std::size_t i = 0; i < bytes; ++i) {
+            out[i] = static_cast<char>(value >> (8 * i));
+        }
+    }
+
+    uint64_t getLittleEndian(const char* in, std::size_t bytes) noexcept {
+        uint64_t value = 0;
+        for (std::size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    bool parseDigits(std::string_view text, std::size_t pos, std::size_t count, int& value) noexcept {
+        if (pos + count > text.size()) return false;
+        value = 0;
+        for (std::size_t i = pos; i < pos + count; ++i) {
+            if (text[i] < '0' || text[i] > '9') return false;
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    }
+
+    // Matches the two header lines FileLogSink writes: "[LEVEL] (function:line)" then "[time] message"
+    bool parseHeader(std::string_view data, std::size_t pos, utils::LogLevel& level, uint64_t& timestamp) noexcept {
+        static constexpr std::array<std::string_view, utils::LEVEL_COUNT> names{
+            "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+
+        if (pos >= data.size() || data[pos] != '[') return false;
+        const std::size_t close = data.find(']', pos);
+        if (close == std::string_view::npos || close - pos > 9 || data.substr(close, 3) != "] (") return false;
+        const std::string_view name = data.substr(pos + 1, close - pos - 1);
+        const auto found = std::find(names.begin(), names.end(), name);
+        if (found == names.end()) return false;
+
+        const std::size_t second = data.find('\n', close);
+        if (second == std::string_view::npos || second + 1 >= data.size() || data[second + 1] != '[') return false;
+        const std::size_t timeEnd = data.find(']', second + 1);
+        if (timeEnd == std::string_view::npos || !FileLogReader::parseTime(data.substr(second + 2, timeEnd - second - 2), timestamp)) {
+            return false;
+        }
+        level = static_cast<utils::LogLevel>(found - names.begin());
+        return true;
+    }
+
+    // Start of the last record in data that begins after its first byte, or 0
+    std::size_t lastRecordStart(std::string_view data) noexcept {
+        utils::LogLevel level;
+        uint64_t timestamp;
+        for (std::size_t pos = data.rfind('\n'); pos != std::string_view::npos && pos != 0; pos = data.rfind('\n', pos - 1)) {
+            if (parseHeader(data, pos + 1, level, timestamp)) return pos + 1;
+        }
+        return 0;
+    }
+}
+
+void FileLogIndex::encode(const Entry& entry, char* out) noexcept {
+    std::memset(out, 0, ENTRY_SIZE);
+    putLittleEndian(out, entry.offset, 8);
+    putLittleEndian(out + 8, entry.length, 4);
+    out[12] = static_cast<char>(entry.levels);
+    putLittleEndian(out + 16, entry.minTime, 8);
+    putLittleEndian(out + 24, entry.maxTime, 8);
+}
+
+FileLogIndex::Entry FileLogIndex::decode(const char* in) noexcept {
+    Entry entry;
+    entry.offset = getLittleEndian(in, 8);
+    entry.length = static_cast<uint32_t>(getLittleEndian(in + 8, 4));
+    entry.levels = static_cast<utils::LevelMask>(in[12]);
+    entry.minTime = getLittleEndian(in + 16, 8);
+    entry.maxTime = getLittleEndian(in + 24, 8);
+    return entry;
+}
+
+FileLogReader::FileLogReader(std::string_view path)
+    : path(path), file(this->path, std::ios::binary) {
+    if (!file.is_open()) {
+        throw std::runtime_error(fmt::format("Failed to open log file: {}", path));
+    }
+    file.seekg(0, std::ios::end);
+    fileSize = static_cast<uint64_t>(file.tellg());
+    loadIndex();
+}
+
+void FileLogReader::loadIndex() {
+    std::ifstream index(FileLogIndex::pathFor(path), std::ios::binary);
+    if (!index.is_open()) return;
+
+    char header[FileLogIndex::HEADER_SIZE];
+    if (!index.read(header, sizeof(header)) || std::memcmp(header, FileLogIndex::MAGIC, sizeof(FileLogIndex::MAGIC)) != 0 ||
+        static_cast<uint8_t>(header[sizeof(FileLogIndex::MAGIC)]) != FileLogIndex::VERSION) {
+        return;
+    }
+
+    char raw[FileLogIndex::ENTRY_SIZE];
+    while (index.read(raw, sizeof(raw))) {
+        const FileLogIndex::Entry entry = FileLogIndex::decode(raw);
+        // Entries past the end describe data this file no longer has (or not yet, if read mid-write)
+        if (entry.length != 0 && entry.offset + entry.length <= fileSize) {
+            entries.push_back(entry);
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; });
+    hasIndex = true;
+}
+
+FileLogReader::Stats FileLogReader::query(const Query& query, const std::function<void(const Record&)>& callback) {
+    Stats stats;
+    stats.blocks = entries.size();
+
+    const auto scanRange = [&](uint64_t offset, uint64_t length) {
+        ++stats.blocksRead;
+        std::size_t carried = 0;
+        while (length != 0) {
+            const auto chunk = static_cast<std::size_t>(std::min<uint64_t>(length, std::max(CHUNK_SIZE, carried * 2)));
+            block.resize(chunk);
+            file.clear();
+            file.seekg(static_cast<std::streamoff>(offset));
+            file.read(block.data(), static_cast<std::streamsize>(chunk));
+            const auto got = static_cast<std::size_t>(file.gcount());
+            if (got == 0) return;
+            stats.bytesRead += got;
+            std::string_view data(block.data(), got);
+
+            // Only cut at a record boundary; the rest is read again with the next chunk
+            std::size_t end = data.size();
+            if (got < length) {
+                end = lastRecordStart(data);
+                if (end == 0) {
+                    carried = got;    // One record larger than the chunk: read a bigger chunk
+                    continue;
+                }
+            }
+            stats.matches += scan(data.substr(0, end), query, callback);
+            offset += end;
+            length -= end;
+            carried = 0;
+            if (got < chunk) return;
+        }
+    };
+
+    uint64_t cursor = 0;
+    for (const auto& entry : entries) {
+        if (entry.offset > cursor) {
+            scanRange(cursor, entry.offset - cursor);
+        }
+        if (entry.maxTime >= query.from && entry.minTime <= query.to && (entry.levels & query.levels) != 0) {
+            scanRange(entry.offset, entry.length);
+        }
+        cursor = std::max(cursor, entry.offset + entry.length);
+    }
+    if (cursor < fileSize) {
+        scanRange(cursor, fileSize - cursor);
+    }
+    return stats;
+}
+
+uint64_t FileLogReader::scan(std::string_view data, const Query& query, const std::function<void(const Record&)>& callback) {
+    uint64_t matches = 0;
+    Record current;
+    std::size_t start = std::string_view::npos;
+
+    const auto emit = [&](std::size_t end) {
+        if (start == std::string_view::npos) return;
+        if (current.timestamp >= query.from && current.timestamp <= query.to &&
+            (query.levels & utils::levelBit(current.level)) != 0) {
+            current.text = data.substr(start, end - start);
+            callback(current);
+            ++matches;
+        }
+    };
+
+    for (std::size_t pos = 0; pos < data.size();) {
+        utils::LogLevel level;
+        uint64_t timestamp;
+        if (parseHeader(data, pos, level, timestamp)) {
+            emit(pos);
+            start = pos;
+            current.level = level;
+            current.timestamp = timestamp;
+        }
+        const std::size_t lineEnd = data.find('\n', pos);
+        pos = lineEnd == std::string_view::npos ? data.size() : lineEnd + 1;
+    }
+    emit(data.size());
+    return matches;
+}
+
+bool FileLogReader::parseTime(std::string_view text, uint64_t& timestamp) noexcept {
+    int year, month, day, hour, minute, second;
+    if (text.size() < 19 || text[4] != '-' || text[7] != '-' || text[10] != ' ' || text[13] != ':' || text[16] != ':' ||
+        !parseDigits(text, 0, 4, year) || !parseDigits(text, 5, 2, month) || !parseDigits(text, 8, 2, day) ||
+        !parseDigits(text, 11, 2, hour) || !parseDigits(text, 14, 2, minute) || !parseDigits(text, 17, 2, second)) {
+        return false;
+    }
+
+    uint64_t fraction = 0;
+    if (text.size() > 19) {
+        if (text[19] != '.' || text.size() > 29) return false;
+        uint64_t scale = 1'000'000'000;
+        for (std::size_t i = 20; i < text.size(); ++i) {
+            if (text[i] < '0' || text[i] > '9') return false;
+            scale /= 10;
+            fraction += static_cast<uint64_t>(text[i] - '0') * scale;
+        }
+    }
+
+    // mktime is slow and records of the same second are adjacent: cache the last conversion
+    static thread_local char cachedText[19]{};
+    static thread_local int64_t cachedSeconds = -1;
+    if (cachedSeconds < 0 || std::memcmp(cachedText, text.data(), sizeof(cachedText)) != 0) {
+        std::tm parts{};
+        parts.tm_year = year - 1900;
+        parts.tm_mon = month - 1;
+        parts.tm_mday = day;
+        parts.tm_hour = hour;
+        parts.tm_min = minute;
+        parts.tm_sec = second;
+        parts.tm_isdst = -1;
+        const std::time_t seconds = std::mktime(&parts);
+        if (seconds < 0) return false;
+        std::memcpy(cachedText, text.data(), sizeof(cachedText));
+        cachedSeconds = seconds;
+    }
+    timestamp = static_cast<uint64_t>(cachedSeconds) * 1'000'000'000 + fraction;
+    return true;
+}
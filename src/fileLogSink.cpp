@@ -1,26 +1,351 @@
 #include "loggerCpp/fileLogSink.hpp"
 
+#include <fmt/format.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+    // Backoff between attempts to set up the next segment after a failure
+    constexpr std::chrono::seconds RETRY_MIN{1};
+    constexpr std::chrono::seconds RETRY_MAX{60};
+}
+
 void FileLogSink::write(const utils::LogEvent& event) {
+    writeBatch({&event, 1});
+}
+
+void FileLogSink::writeBatch(std::span<const utils::LogEvent> events) {
     if (!fileName.is_open()) {
         std::cerr << "Error: Log file not found or cannot be opened\n";
         return;
     }
 
-    // Use std::format for more efficient string formatting
-    fileName << std::format("[{}] ({}:{})\n[{}] {}\n", 
+    if (std::chrono::system_clock::now() >= rotateAt && rotationReady()) [[unlikely]] {
+        writeBuffer();
+        rotate();
+    }
+
+    bool urgent = false;
+    for (const auto& event : events) {
+        if (rotation.maxBytes != 0 && segmentBytes + buffer.size() >= rotation.maxBytes && rotationReady()) [[unlikely]] {
+            writeBuffer();
+            rotate();
+        }
+        appendEvent(event);
+        urgent |= event.level >= policy.flushLevel;
+        if (buffer.size() >= policy.bufferSize) [[unlikely]] {
+            writeBuffer();
+        }
+    }
+
+    if (urgent || std::chrono::steady_clock::now() - lastFlush >= policy.interval) {
+        writeBuffer();
+    }
+    throwWriteError();
+}
+
+void FileLogSink::flush() {
+    writeBuffer();
+    // Quiet files still roll over on time
+    if (std::chrono::system_clock::now() >= rotateAt && rotationReady()) [[unlikely]] {
+        rotate();
+    }
+    throwWriteError();
+}
+
+void FileLogSink::writeBuffer() {
+    if (buffer.size() != 0) {
+        errno = 0;
+        fileName.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!fileName) [[unlikely]] {
+            // A failed stream ignores every later write until cleared. Drop the buffer and the
+            // index entries describing it, and count only what really reached the file
+            writeError = errno != 0 ? std::strerror(errno) : "write failed";
+            fileName.clear();
+            const auto position = fileName.tellp();
+            if (position >= 0) segmentBytes = static_cast<std::size_t>(position);
+            buffer.clear();
+            indexBuffer.clear();
+            block = {};
+            lastFlush = std::chrono::steady_clock::now();
+            return;
+        }
+        segmentBytes += buffer.size();
+        buffer.clear();
+    }
+    // Entries only ever describe data that has been written before them
+    if (indexBuffer.size() != 0) {
+        indexFile.write(indexBuffer.data(), static_cast<std::streamsize>(indexBuffer.size()));
+        if (!indexFile) [[unlikely]] {
+            writeError = fmt::format("index: {}", errno != 0 ? std::strerror(errno) : "write failed");
+            indexFile.clear();
+        }
+        indexBuffer.clear();
+    }
+    lastFlush = std::chrono::steady_clock::now();
+}
+
+void FileLogSink::throwWriteError() {
+    if (!writeError.empty()) [[unlikely]] {
+        throw std::runtime_error(fmt::format("Failed to write log file {}: {}", path, std::exchange(writeError, {})));
+    }
+}
+
+void FileLogSink::appendEvent(const utils::LogEvent& event) {
+    const std::size_t start = buffer.size();
+    fmt::format_to(fmt::appender(buffer), "[{}] {}\n[{}] ",
         utils::getLogLevelString(event.level),
-       // event.location.file_name(),
-        event.location.function_name(),
-        event.location.line(),
-        event.timestamp,
-        event.message);
+        locations.get(event.site, [](const utils::CallSite& site, std::string& text) {
+            text = fmt::format("({}:{})", site.function, site.line);
+        }),
+        timestampFormatter.format(event.timestamp));
+
+    // Continuation lines of a multi-line message are indented with a tab, so no line of the
+    // message can be taken for the "[LEVEL] (" header that starts a record
+    std::string_view message = event.message();
+    for (std::size_t newline; (newline = message.find('\n')) != std::string_view::npos;) {
+        buffer.append(message.substr(0, newline + 1));
+        buffer.push_back('\t');
+        message.remove_prefix(newline + 1);
+    }
+    buffer.append(message);
+    buffer.push_back('\n');
+
+    if (indexPolicy.enabled()) {
+        if (block.length == 0) {
+            block.offset = segmentBytes + start;
+        }
+        block.length += static_cast<uint32_t>(buffer.size() - start);
+        block.levels |= utils::levelBit(event.level);
+        block.minTime = std::min(block.minTime, event.timestamp);
+        block.maxTime = std::max(block.maxTime, event.timestamp);
+        if (block.length >= indexPolicy.blockBytes) {
+            closeBlock();
+        }
+    }
+}
+
+void FileLogSink::closeBlock() noexcept {
+    if (block.length == 0) return;
+    char entry[FileLogIndex::ENTRY_SIZE];
+    FileLogIndex::encode(block, entry);
+    indexBuffer.append(entry, entry + sizeof(entry));
+    block = {};
+}
+
+void FileLogSink::openIndex(std::ofstream& stream, const std::string& indexPath, std::ios::openmode mode) {
+    stream.rdbuf()->pubsetbuf(nullptr, 0);
+    stream.open(indexPath, mode | std::ios::binary);
+    if (!stream.is_open()) {
+        throw std::runtime_error(fmt::format("Failed to open log index: {}", indexPath));
+    }
+    std::error_code ec;
+    if (std::filesystem::file_size(indexPath, ec) == 0 && !ec) {
+        stream.write(FileLogIndex::MAGIC, sizeof(FileLogIndex::MAGIC));
+        stream.put(static_cast<char>(FileLogIndex::VERSION));
+    }
+}
+
+bool FileLogSink::rotate() {
+    std::ofstream* next = nextSegment.exchange(nullptr, std::memory_order_acquire);
+    if (next == nullptr) [[unlikely]] {
+        // Still being prepared: keep writing to the current segment rather than stall
+        return false;
+    }
+
+    if (indexPolicy.enabled()) {
+        // The caller has just written the buffer out; close the segment's index with its last block
+        closeBlock();
+        writeBuffer();
+        std::unique_ptr<std::ofstream> nextIndexFile(nextIndex.exchange(nullptr, std::memory_order_acquire));
+        if (nextIndexFile) {
+            indexFile.swap(*nextIndexFile);
+        }
+    }
+
+    fileName.swap(*next);
+    segmentBytes = 0;
+    scheduleRotation();
+    retryDelay = RETRY_MIN;
+    stallReported = false;
+    {
+        std::lock_guard lock(rotationMutex);
+        retiredSegments.emplace_back(next);
+    }
+    rotationCV.notify_one();
+    return true;
 }
 
+bool FileLogSink::rotationReady() {
+    if (nextSegment.load(std::memory_order_acquire) != nullptr) [[likely]] return true;
+    if (!prepareFailed.load(std::memory_order_acquire)) return false;   // Still being prepared
 
-FileLogSink::FileLogSink(std::string_view name) : fileName(std::string(name), std::ios::app | std::ios::binary) {
+    // The rotation thread gave up on name.next: keep appending to the current segment and have
+    // it try again, backing off so a persistent failure costs nothing per event
+    const auto now = std::chrono::steady_clock::now();
+    if (now < retryAt) return false;
+    if (!stallReported) {
+        std::cerr << "Error: Rotation of log file " << path << " is stalled, writing on to the current segment\n";
+        stallReported = true;
+    }
+    retryAt = now + retryDelay;
+    retryDelay = std::min(retryDelay * 2, RETRY_MAX);
+    {
+        std::lock_guard lock(rotationMutex);
+        retryRequested = true;
+    }
+    rotationCV.notify_one();
+    return false;
+}
+
+void FileLogSink::scheduleRotation() noexcept {
+    if (rotation.interval.count() == 0) {
+        rotateAt = std::chrono::system_clock::time_point::max();
+        return;
+    }
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    const auto interval = std::chrono::duration_cast<std::chrono::system_clock::duration>(rotation.interval);
+    rotateAt = std::chrono::system_clock::time_point((now / interval + 1) * interval);
+}
+
+void FileLogSink::rotationLoop(std::stop_token stop) {
+    prepareFailed.store(!prepareNextSegment(), std::memory_order_release);
+
+    // Set while the active segment is still named name.next: re-creating it would truncate it
+    bool activeIsNext = false;
+    std::unique_lock lock(rotationMutex);
+    while (rotationCV.wait(lock, stop, [this] { return !retiredSegments.empty() || retryRequested; })) {
+        auto retired = std::move(retiredSegments);
+        retiredSegments.clear();
+        retryRequested = false;
+        lock.unlock();
+
+        for (auto& segment : retired) {
+            segment->close();
+            activeIsNext = !shiftSegments();
+        }
+        retired.clear();
+        if (activeIsNext) {
+            activeIsNext = !promoteNext();
+        }
+        const bool prepared = !activeIsNext && (nextSegment.load(std::memory_order_acquire) != nullptr || prepareNextSegment());
+        prepareFailed.store(!prepared, std::memory_order_release);
+
+        lock.lock();
+    }
+}
+
+bool FileLogSink::prepareNextSegment() {
+    if (indexPolicy.enabled()) {
+        auto index = std::make_unique<std::ofstream>();
+        try {
+            openIndex(*index, FileLogIndex::pathFor(segmentPath(0)), std::ios::trunc);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << '\n';
+            return false;
+        }
+        delete nextIndex.exchange(index.release(), std::memory_order_release);
+    }
+
+    auto next = std::make_unique<std::ofstream>();
+    next->rdbuf()->pubsetbuf(nullptr, 0);
+    next->open(segmentPath(0), std::ios::trunc | std::ios::binary);
+    if (!next->is_open()) {
+        std::cerr << "Error: Failed to pre-open next log segment " << segmentPath(0) << '\n';
+        return false;
+    }
+    nextSegment.store(next.release(), std::memory_order_release);
+    return true;
+}
+
+bool FileLogSink::shiftSegments() {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+
+    std::size_t last = 0;
+    while (fs::exists(segmentPath(last + 1), ec)) {
+        ++last;
+    }
+
+    // Drop what falls out of retention, then move every older segment up one slot, indexes along
+    std::error_code indexEc;
+    for (; rotation.maxFiles != 0 && last >= rotation.maxFiles; --last) {
+        fs::remove(segmentPath(last), ec);
+        fs::remove(FileLogIndex::pathFor(segmentPath(last)), indexEc);
+    }
+    for (std::size_t index = last; index >= 1; --index) {
+        fs::rename(segmentPath(index), segmentPath(index + 1), ec);
+        fs::rename(FileLogIndex::pathFor(segmentPath(index)), FileLogIndex::pathFor(segmentPath(index + 1)), indexEc);
+    }
+    fs::rename(path, segmentPath(1), ec);
+    if (indexPolicy.enabled()) {
+        fs::rename(FileLogIndex::pathFor(path), FileLogIndex::pathFor(segmentPath(1)), indexEc);
+        fs::rename(FileLogIndex::pathFor(segmentPath(0)), FileLogIndex::pathFor(path), indexEc);
+    }
+
+    return promoteNext();
+}
+
+bool FileLogSink::promoteNext() {
+    // The logging thread is already writing to name.next; give it the stable name
+    std::error_code ec;
+    std::filesystem::rename(segmentPath(0), path, ec);
+    if (ec == std::errc::no_such_file_or_directory) {
+        // Removed from under us: there is nothing left that preparing name.next could truncate
+        return true;
+    }
+    if (ec) {
+        std::cerr << "Error: Failed to rotate log file " << path << ": " << ec.message() << '\n';
+        return false;
+    }
+    return true;
+}
+
+std::string FileLogSink::segmentPath(std::size_t index) const {
+    return index == 0 ? path + ".next" : fmt::format("{}.{}", path, index);
+}
+
+
+FileLogSink::FileLogSink(std::string_view name, const FileFlushPolicy& policy, const FileRotationPolicy& rotation,
+                         const FileIndexPolicy& index)
+    : path(name), policy(policy), rotation(rotation), indexPolicy(index), lastFlush(std::chrono::steady_clock::now()) {
+    // Buffering is done in buffer, so each flush is a single write. Must precede open() to take effect
+    fileName.rdbuf()->pubsetbuf(nullptr, 0);
+    fileName.open(path, std::ios::app | std::ios::binary);
     if (!fileName.is_open()) {
-        throw std::runtime_error(std::format("Failed to open log file: {}", name));
+        throw std::runtime_error(fmt::format("Failed to open log file: {}", name));
+    }
+    buffer.reserve(this->policy.bufferSize);
+    if (indexPolicy.enabled()) {
+        openIndex(indexFile, FileLogIndex::pathFor(path), std::ios::app);
+    }
+
+    std::error_code ec;
+    const auto existing = std::filesystem::file_size(path, ec);
+    segmentBytes = ec ? 0 : static_cast<std::size_t>(existing);
+    scheduleRotation();
+    if (this->rotation.enabled()) {
+        rotationThread = std::jthread([this](std::stop_token stop) { rotationLoop(stop); });
     }
-    fileName.rdbuf()->pubsetbuf(nullptr, 0); // Disable buffering for immediate writes
 }
 
+FileLogSink::~FileLogSink() noexcept {
+    closeBlock();
+    writeBuffer();
+    if (rotationThread.joinable()) {
+        rotationThread.request_stop();
+        rotationThread.join();
+    }
+    if (std::ofstream* next = nextSegment.exchange(nullptr)) {
+        delete next;
+        std::error_code ec;
+        std::filesystem::remove(segmentPath(0), ec);
+    }
+    if (std::ofstream* index = nextIndex.exchange(nullptr)) {
+        delete index;
+        std::error_code ec;
+        std::filesystem::remove(FileLogIndex::pathFor(segmentPath(0)), ec);
+    }
+}
@@ -0,0 +1,46 @@
+#include "loggerCpp/formatArgs.hpp"
+
+namespace {
+    // Pushes the encoded arguments into the store; strings reference the event's bytes
+    void decodeArgs(const utils::LogEvent& event, fmt::dynamic_format_arg_store<fmt::format_context>& store) {
+        utils::visitArgs(event.args(), [&store](const auto& value) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(value)>, std::string_view>) {
+                store.push_back(fmt::string_view(value.data(), value.size()));
+            } else {
+                store.push_back(value);
+            }
+        });
+    }
+}
+
+bool utils::hasFields(std::string_view encoded) noexcept {
+    bool found = false;
+    visitFields(encoded, [&found](std::string_view, const auto&) { found = true; });
+    return found;
+}
+
+std::string_view utils::formatDeferred(const LogEvent& event, FormatScratch& scratch) noexcept {
+    const std::string_view format = event.format();
+    scratch.buffer.clear();
+    scratch.store.clear();
+    try {
+        decodeArgs(event, scratch.store);
+        fmt::vformat_to(fmt::appender(scratch.buffer), fmt::string_view(format.data(), format.size()), scratch.store);
+    } catch (const std::exception& e) {
+        scratch.buffer.clear();
+        fmt::format_to(fmt::appender(scratch.buffer), "[format error: {}] {}", e.what(), format);
+    }
+    return {scratch.buffer.data(), scratch.buffer.size()};
+}
+
+void utils::renderDeferred(LogEvent& event, FormatScratch& scratch) noexcept {
+    formatDeferred(event, scratch);
+    try {
+        visitFields(event.args(), [&scratch](std::string_view key, const auto& value) {
+            fmt::format_to(fmt::appender(scratch.buffer), " {}={}", key, value);
+        });
+    } catch (const std::exception&) {
+        // Out of memory while growing the buffer: keep the message without the remaining fields
+    }
+    event.setRenderedMessage(std::string_view(scratch.buffer.data(), scratch.buffer.size()));
+}
@@ -0,0 +1,131 @@
+#include "loggerCpp/isolatedLogSink.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+IsolatedLogSink::IsolatedLogSink(std::shared_ptr<LogSink> sink, const IsolatedSinkOptions& options)
+    : sink(std::move(sink)), options(options), queue(options.capacity) {
+    if (!this->sink) {
+        throw std::invalid_argument("IsolatedLogSink needs a sink to wrap");
+    }
+    this->options.batchSize = std::max<std::size_t>(this->options.batchSize, 1);
+    batch.reserve(this->options.batchSize);
+    worker = std::jthread([this](std::stop_token stop) { workerLoop(stop); });
+}
+
+IsolatedLogSink::~IsolatedLogSink() noexcept {
+    worker.request_stop();
+    wakeWorker();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void IsolatedLogSink::write(const utils::LogEvent& event) {
+    writeBatch({&event, 1});
+}
+
+void IsolatedLogSink::writeBatch(std::span<const utils::LogEvent> events) {
+    uint64_t accepted = 0;
+    uint64_t newest = 0;
+    for (const auto& event : events) {
+        if (queue.tryPush(utils::LogEvent(event))) [[likely]] {
+            ++accepted;
+            newest = event.timestamp;
+        } else {
+            // Never wait for a slow sink: that would stall every other sink on the logging thread
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (accepted != 0) {
+        enqueued.fetch_add(accepted, std::memory_order_relaxed);
+        newestEnqueued.store(newest, std::memory_order_relaxed);
+        wakeWorker();
+    }
+}
+
+void IsolatedLogSink::flush() {
+    flushRequested.store(true, std::memory_order_relaxed);
+    wakeWorker();
+}
+
+SinkStats IsolatedLogSink::stats() const noexcept {
+    SinkStats result;
+    result.enqueued = enqueued.load(std::memory_order_relaxed);
+    result.written = written.load(std::memory_order_relaxed);
+    result.failed = failed.load(std::memory_order_relaxed);
+    result.errors = errors.load(std::memory_order_relaxed);
+    result.dropped = dropped.load(std::memory_order_relaxed);
+    result.backlog = queue.size();
+    const uint64_t newest = newestEnqueued.load(std::memory_order_relaxed);
+    const uint64_t done = newestWritten.load(std::memory_order_relaxed);
+    result.lag = std::chrono::nanoseconds(result.backlog != 0 && newest > done ? newest - done : 0);
+    return result;
+}
+
+void IsolatedLogSink::wakeWorker() noexcept {
+    // Same handshake as LoggingEngine::wakeConsumer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (workerSleeping.load(std::memory_order_relaxed) && workerSleeping.exchange(false)) {
+        queueSem.release();
+    }
+}
+
+std::size_t IsolatedLogSink::drainBatch() noexcept {
+    batch.clear();
+    while (batch.size() < options.batchSize) {
+        auto event = queue.tryPop();
+        if (!event) break;
+        batch.push_back(std::move(*event));
+    }
+
+    if (!batch.empty()) {
+        try {
+            sink->writeBatch(batch);
+            written.fetch_add(batch.size(), std::memory_order_relaxed);
+        } catch (...) {
+            // Count the batch as lost and keep draining: the next one may well succeed
+            failed.fetch_add(batch.size(), std::memory_order_relaxed);
+            errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        newestWritten.store(batch.back().timestamp, std::memory_order_relaxed);
+    }
+    return batch.size();
+}
+
+void IsolatedLogSink::flushSink() noexcept {
+    try {
+        sink->flush();
+    } catch (...) {
+        errors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void IsolatedLogSink::workerLoop(std::stop_token stop) noexcept {
+    while (true) {
+        while (drainBatch() != 0) {}
+
+        if (flushRequested.exchange(false, std::memory_order_relaxed)) {
+            flushSink();
+        }
+
+        if (stop.stop_requested()) [[unlikely]] {
+            if (queue.empty()) break;
+            continue;
+        }
+
+        // Park until the logging thread wakes us; re-check after announcing it
+        workerSleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!queue.empty() || stop.stop_requested() || flushRequested.load(std::memory_order_relaxed)) {
+            if (!workerSleeping.exchange(false)) queueSem.acquire();
+            continue;
+        }
+
+        if (!queueSem.try_acquire_for(IDLE_TIMEOUT)) {
+            // Timed out, but a wakeup may have been claimed in the meantime
+            if (!workerSleeping.exchange(false)) queueSem.acquire();
+        }
+    }
+    flushSink();
+}
@@ -0,0 +1,158 @@
+#include "loggerCpp/jsonEscape.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define LOGGERCPP_ESCAPE_SSE2
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define LOGGERCPP_ESCAPE_AVX2   // Compiled with a target attribute, chosen at run time
+#endif
+#endif
+
+namespace {
+    // Bytes that need escaping inside a JSON string
+    bool isJsonSpecial(unsigned char c) noexcept {
+        return c < 0x20 || c == '"' || c == '\\';
+    }
+
+    // Bytes a terminal would interpret: control characters but newline and tab, and DEL
+    bool isTerminalSpecial(unsigned char c) noexcept {
+        return (c < 0x20 && c != '\n' && c != '\t') || c == 0x7F;
+    }
+
+    using FindSpecial = std::size_t (*)(const char* data, std::size_t size) noexcept;
+
+    template<bool (*isSpecial)(unsigned char)>
+    std::size_t findScalar(const char* data, std::size_t size, std::size_t pos) noexcept {
+        while (pos < size && !isSpecial(static_cast<unsigned char>(data[pos]))) ++pos;
+        return pos;
+    }
+
+#ifdef LOGGERCPP_ESCAPE_SSE2
+    // Lanes <= 0x1F: unsigned compare through max
+    __m128i controlMask(__m128i v) noexcept {
+        const __m128i limit = _mm_set1_epi8(0x1F);
+        return _mm_cmpeq_epi8(_mm_max_epu8(v, limit), limit);
+    }
+
+    std::size_t findJsonSse2(const char* data, std::size_t size) noexcept {
+        std::size_t pos = 0;
+        for (; pos + 16 <= size; pos += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            const __m128i special = _mm_or_si128(controlMask(v),
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))));
+            if (const int mask = _mm_movemask_epi8(special)) return pos + static_cast<std::size_t>(std::countr_zero(static_cast<uint32_t>(mask)));
+        }
+        return findScalar<isJsonSpecial>(data, size, pos);
+    }
+
+    std::size_t findTerminalSse2(const char* data, std::size_t size) noexcept {
+        std::size_t pos = 0;
+        for (; pos + 16 <= size; pos += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            const __m128i allowed = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+            const __m128i special = _mm_or_si128(_mm_andnot_si128(allowed, controlMask(v)), _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F)));
+            if (const int mask = _mm_movemask_epi8(special)) return pos + static_cast<std::size_t>(std::countr_zero(static_cast<uint32_t>(mask)));
+        }
+        return findScalar<isTerminalSpecial>(data, size, pos);
+    }
+#endif
+
+#ifdef LOGGERCPP_ESCAPE_AVX2
+    __attribute__((target("avx2"))) __m256i controlMask256(__m256i v) noexcept {
+        const __m256i limit = _mm256_set1_epi8(0x1F);
+        return _mm256_cmpeq_epi8(_mm256_max_epu8(v, limit), limit);
+    }
+
+    __attribute__((target("avx2"))) std::size_t findJsonAvx2(const char* data, std::size_t size) noexcept {
+        std::size_t pos = 0;
+        for (; pos + 32 <= size; pos += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            const __m256i special = _mm256_or_si256(controlMask256(v),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))));
+            if (const int mask = _mm256_movemask_epi8(special)) return pos + static_cast<std::size_t>(std::countr_zero(static_cast<uint32_t>(mask)));
+        }
+        return pos + findJsonSse2(data + pos, size - pos);
+    }
+
+    __attribute__((target("avx2"))) std::size_t findTerminalAvx2(const char* data, std::size_t size) noexcept {
+        std::size_t pos = 0;
+        for (; pos + 32 <= size; pos += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            const __m256i allowed = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+            const __m256i special = _mm256_or_si256(_mm256_andnot_si256(allowed, controlMask256(v)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7F)));
+            if (const int mask = _mm256_movemask_epi8(special)) return pos + static_cast<std::size_t>(std::countr_zero(static_cast<uint32_t>(mask)));
+        }
+        return pos + findTerminalSse2(data + pos, size - pos);
+    }
+#endif
+
+    std::size_t findJson(const char* data, std::size_t size) noexcept {
+        return findScalar<isJsonSpecial>(data, size, 0);
+    }
+
+    std::size_t findTerminal(const char* data, std::size_t size) noexcept {
+        return findScalar<isTerminalSpecial>(data, size, 0);
+    }
+
+    // Widest scanner the CPU supports, picked on first use
+    struct Scanners {
+        FindSpecial json{findJson};
+        FindSpecial terminal{findTerminal};
+
+        Scanners() noexcept {
+#ifdef LOGGERCPP_ESCAPE_SSE2
+            json = findJsonSse2;
+            terminal = findTerminalSse2;
+#endif
+#ifdef LOGGERCPP_ESCAPE_AVX2
+            if (__builtin_cpu_supports("avx2")) {
+                json = findJsonAvx2;
+                terminal = findTerminalAvx2;
+            }
+#endif
+        }
+    };
+
+    const Scanners& scanners() noexcept {
+        static const Scanners instance;
+        return instance;
+    }
+
+    // Copies clean runs whole and hands each special byte to escape
+    template<typename Escape>
+    void appendEscaped(fmt::memory_buffer& out, std::string_view text, FindSpecial find, Escape&& escape) {
+        const char* data = text.data();
+        std::size_t size = text.size();
+        while (size != 0) {
+            const std::size_t clean = find(data, size);
+            out.append(data, data + clean);
+            if (clean == size) return;
+            escape(static_cast<unsigned char>(data[clean]));
+            data += clean + 1;
+            size -= clean + 1;
+        }
+    }
+}
+
+void utils::appendJsonEscaped(fmt::memory_buffer& out, std::string_view text) {
+    appendEscaped(out, text, scanners().json, [&out](unsigned char c) {
+        switch (c) {
+            case '"': out.append(std::string_view("\\\"")); break;
+            case '\\': out.append(std::string_view("\\\\")); break;
+            case '\n': out.append(std::string_view("\\n")); break;
+            case '\r': out.append(std::string_view("\\r")); break;
+            case '\t': out.append(std::string_view("\\t")); break;
+            default: fmt::format_to(fmt::appender(out), "\\u{:04x}", static_cast<unsigned>(c));
+        }
+    });
+}
+
+void utils::appendSanitized(fmt::memory_buffer& out, std::string_view text) {
+    appendEscaped(out, text, scanners().terminal, [&out](unsigned char c) {
+        fmt::format_to(fmt::appender(out), "\\x{:02x}", static_cast<unsigned>(c));
+    });
+}
@@ -0,0 +1,127 @@
+#include "loggerCpp/jsonLogSink.hpp"
+#include "loggerCpp/jsonEscape.hpp"
+
+#include <cmath>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+
+JsonLogSink::JsonLogSink(std::string_view fileName, const FileFlushPolicy& policy)
+    : policy(policy), lastFlush(std::chrono::steady_clock::now()) {
+    // Buffering is done in buffer, so each flush is a single write. Must precede open() to take effect
+    file.rdbuf()->pubsetbuf(nullptr, 0);
+    file.open(std::string(fileName), std::ios::app | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(fmt::format("Failed to open log file: {}", fileName));
+    }
+    buffer.reserve(this->policy.bufferSize);
+}
+
+JsonLogSink::~JsonLogSink() noexcept {
+    writeBuffer();
+}
+
+void JsonLogSink::write(const utils::LogEvent& event) {
+    writeBatch({&event, 1});
+}
+
+void JsonLogSink::writeBatch(std::span<const utils::LogEvent> events) {
+    bool urgent = false;
+    for (const auto& event : events) {
+        appendEvent(event);
+        urgent |= event.level >= policy.flushLevel;
+        if (buffer.size() >= policy.bufferSize) [[unlikely]] {
+            writeBuffer();
+        }
+    }
+
+    if (urgent || std::chrono::steady_clock::now() - lastFlush >= policy.interval) {
+        writeBuffer();
+    }
+}
+
+void JsonLogSink::flush() {
+    writeBuffer();
+}
+
+void JsonLogSink::appendEvent(const utils::LogEvent& event) {
+    // The rendered message of an event with fields ends in their " key=value" text; render it again without
+    const bool structured = event.format().data() != nullptr && utils::hasFields(event.args());
+    const std::string_view message = structured ? utils::formatDeferred(event, scratch) : event.message();
+
+    fmt::format_to(fmt::appender(buffer), R"({{"timestamp":"{}","level":"{}","file":")",
+        formatTimestamp(event.timestamp), utils::getLogLevelString(event.level));
+    // File, line and function are escaped once per call site
+    buffer.append(locations.get(event.site, [](const utils::CallSite& site, std::string& text) {
+        fmt::memory_buffer out;
+        utils::appendJsonEscaped(out, site.file);
+        fmt::format_to(fmt::appender(out), R"(","line":{},"function":")", site.line);
+        utils::appendJsonEscaped(out, site.function);
+        text = fmt::to_string(out);
+    }));
+    buffer.append(std::string_view(R"(","message":")"));
+    utils::appendJsonEscaped(buffer, message);
+    buffer.push_back('"');
+    if (structured) {
+        buffer.append(std::string_view(R"(,"fields":{)"));
+        appendFields(event.args());
+        buffer.push_back('}');
+    }
+    buffer.append(std::string_view("}\n"));
+}
+
+void JsonLogSink::appendFields(std::string_view encoded) {
+    bool first = true;
+    utils::visitFields(encoded, [this, &first](std::string_view key, const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        buffer.append(std::string_view(first ? "\"" : ",\""));
+        first = false;
+        utils::appendJsonEscaped(buffer, key);
+        buffer.append(std::string_view("\":"));
+
+        if constexpr (std::is_same_v<T, bool>) {
+            buffer.append(std::string_view(value ? "true" : "false"));
+        } else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, char>) {
+            fmt::format_to(fmt::appender(buffer), "{}", value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            if (std::isfinite(value)) {
+                fmt::format_to(fmt::appender(buffer), "{}", value);
+            } else {
+                fmt::format_to(fmt::appender(buffer), "\"{}\"", value);   // JSON has no NaN or infinity
+            }
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            buffer.push_back('"');
+            utils::appendJsonEscaped(buffer, value);
+            buffer.push_back('"');
+        } else if constexpr (std::is_same_v<T, char>) {
+            buffer.push_back('"');
+            utils::appendJsonEscaped(buffer, std::string_view(&value, 1));
+            buffer.push_back('"');
+        } else {
+            fmt::format_to(fmt::appender(buffer), "\"{}\"", value);
+        }
+    });
+}
+
+std::string_view JsonLogSink::formatTimestamp(uint64_t timestamp) noexcept {
+    const auto seconds = static_cast<int64_t>(timestamp / 1'000'000'000);
+    if (seconds != cachedSecond) {
+        const auto time = static_cast<std::time_t>(seconds);
+        std::tm parts{};
+        ::gmtime_r(&time, &parts);
+        std::strftime(timestampText, sizeof(timestampText), "%Y-%m-%dT%H:%M:%S", &parts);
+        cachedSecond = seconds;
+    }
+    // The prefix is always 19 characters; append ".uuuuuuZ"
+    const auto micros = static_cast<unsigned>(timestamp % 1'000'000'000 / 1000);
+    fmt::format_to(timestampText + 19, ".{:06}Z", micros);
+    return {timestampText, 27};
+}
+
+void JsonLogSink::writeBuffer() {
+    if (buffer.size() != 0) {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    lastFlush = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,35 @@
+#include "loggerCpp/latencyHistogram.hpp"
+
+#include <cmath>
+
+uint64_t utils::LatencyHistogram::percentile(double p) const noexcept {
+    if (count == 0) return 0;
+    const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(count)));
+    uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank && buckets[bucket] != 0) {
+            const uint64_t upper = bucket == 0 ? 0 : (uint64_t{1} << bucket) - 1;
+            return std::min(upper, maxNs);
+        }
+    }
+    return maxNs;
+}
+
+void utils::LatencyHistogram::merge(const LatencyHistogram& other) noexcept {
+    for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+        buckets[bucket] += other.buckets[bucket];
+    }
+    count += other.count;
+    totalNs += other.totalNs;
+    maxNs = std::max(maxNs, other.maxNs);
+}
+
+void utils::AtomicLatencyHistogram::addTo(LatencyHistogram& into) const noexcept {
+    for (std::size_t bucket = 0; bucket < LatencyHistogram::BUCKETS; ++bucket) {
+        into.buckets[bucket] += buckets[bucket].load(std::memory_order_relaxed);
+    }
+    into.count += count.load(std::memory_order_relaxed);
+    into.totalNs += totalNs.load(std::memory_order_relaxed);
+    into.maxNs = std::max(into.maxNs, maxNs.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,64 @@
+#include "loggerCpp/utils.hpp"
+
+#include <algorithm>
+
+utils::LogEvent::LogEvent(const LogEvent& other) noexcept
+    : timestamp(other.timestamp), site(other.site), level(other.level), pending(other.pending), captured(other.captured),
+      argsLength(other.argsLength) {
+    char* out = reserve(other.length);
+    if (out == nullptr) [[unlikely]] {
+        // Keep what fits of the rendered message; cut arguments cannot be decoded
+        setMessage(other.message().substr(0, INLINE_CAPACITY));
+        return;
+    }
+    std::memcpy(out, other.data(), length);
+}
+
+utils::LogEvent& utils::LogEvent::operator=(const LogEvent& other) noexcept {
+    if (this != &other) {
+        LogEvent copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+void utils::LogEvent::setRenderedMessage(std::string_view message) noexcept {
+    const std::size_t size = argsLength + message.size();
+    if (size > (overflow ? capacity : INLINE_CAPACITY)) {
+        // Grow into a new buffer, carrying the arguments over
+        std::size_t granted = 0;
+        char* grown = BufferPool::acquire(size, granted);
+        if (grown == nullptr) [[unlikely]] {
+            message = message.substr(0, (overflow ? capacity : INLINE_CAPACITY) - argsLength);
+        } else {
+            std::memcpy(grown, data(), argsLength);
+            releaseOverflow();
+            overflow = grown;
+            capacity = static_cast<uint32_t>(granted);
+        }
+    }
+    std::memcpy(const_cast<char*>(data()) + argsLength, message.data(), message.size());
+    length = static_cast<uint32_t>(argsLength + message.size());
+    pending = false;
+}
+
+char* utils::LogEvent::reserveOverflow(std::size_t size) noexcept {
+    if (overflow == nullptr || capacity < size) {
+        releaseOverflow();
+        std::size_t granted = 0;
+        overflow = BufferPool::acquire(size, granted);
+        if (overflow == nullptr) [[unlikely]] {
+            length = 0;
+            return nullptr;
+        }
+        capacity = static_cast<uint32_t>(granted);
+    }
+    length = static_cast<uint32_t>(size);
+    return overflow;
+}
+
+void utils::LogEvent::releaseOverflow() noexcept {
+    BufferPool::release(overflow, capacity);
+    overflow = nullptr;
+    capacity = 0;
+}
@@ -1,23 +1,133 @@
 #include "loggerCpp/logEventRouter.hpp"
 #include "loggerCpp/logSink.hpp"
 
-// Remove unnecessary constructor/destructor since we use =default in header
+#include <chrono>
+
+LogEventRouter::LogEventRouter()
+    : snapshot(std::make_shared<const Snapshot>()) {}
+
 void LogEventRouter::setLogLevel(utils::LogLevel level) noexcept {
-    currentLogLevel = level;
+    currentLogLevel.store(level, std::memory_order_relaxed);
+}
+
+void LogEventRouter::addRoute(utils::LevelMask levels, std::shared_ptr<LogSink> sink) {
+    std::lock_guard lock(updateMutex);
+    auto next = std::make_shared<Snapshot>(*snapshot.load(std::memory_order_acquire));
+    next->subscriptions.push_back({std::move(sink), levels, std::make_shared<SinkCounters>()});
+
+    snapshot.store(std::move(next), std::memory_order_release);
+}
+
+void LogEventRouter::replaceRoutes(std::vector<SinkRoute> routes) {
+    std::lock_guard lock(updateMutex);
+    const auto current = snapshot.load(std::memory_order_acquire);
+    auto next = std::make_shared<Snapshot>();
+    next->subscriptions.reserve(routes.size());
+
+    for (SinkRoute& route : routes) {
+        std::shared_ptr<SinkCounters> counters;
+        for (const Subscription& subscription : current->subscriptions) {
+            if (subscription.sink == route.sink) {
+                counters = subscription.counters;
+                break;
+            }
+        }
+        if (!counters) {
+            counters = std::make_shared<SinkCounters>();
+        }
+        next->subscriptions.push_back({std::move(route.sink), route.levels, std::move(counters)});
+    }
+
+    snapshot.store(std::move(next), std::memory_order_release);
 }
 
-void LogEventRouter::addRoute(utils::LogLevel level, std::shared_ptr<LogSink> sink) noexcept {
-    routes[level].push_back(std::move(sink));
+void LogEventRouter::clearRoutes() {
+    std::lock_guard lock(updateMutex);
+    snapshot.store(std::make_shared<const Snapshot>(), std::memory_order_release);
 }
 
 void LogEventRouter::routeEvent(const utils::LogEvent& event) noexcept {
-    // Use [[likely]] hint since most events should be at or above current level
-    if (event.level >= currentLogLevel) [[likely]] {
-        // Use contains() for cleaner check (C++23)
-        if (routes.contains(event.level)) [[likely]] {
-            for (const auto& sink : routes[event.level]) {
-                sink->write(event);
+    routeBatch({&event, 1});
+}
+
+void LogEventRouter::routeBatch(std::span<const utils::LogEvent> events) noexcept {
+    const utils::LevelMask routed = utils::levelsFrom(currentLogLevel.load(std::memory_order_relaxed));
+    const auto routes = snapshot.load(std::memory_order_acquire);
+    std::lock_guard lock(writeMutex);
+
+    utils::LevelMask present = 0;
+    for (const auto& event : events) {
+        present |= utils::levelBit(event.level);
+    }
+
+    for (const Subscription& subscription : routes->subscriptions) {
+        const utils::LevelMask levels = subscription.levels & routed;
+        if ((levels & present) == 0) continue;
+
+        std::span<const utils::LogEvent> accepted = events;
+        if ((present & ~levels) != 0) {
+            // The sink takes only some of the levels: hand it a contiguous run when its events
+            // form one, a filtered copy otherwise, so it still gets a single call per batch
+            std::size_t first = 0;
+            while (!(levels & utils::levelBit(events[first].level))) ++first;
+            std::size_t last = events.size();
+            while (!(levels & utils::levelBit(events[last - 1].level))) --last;
+
+            accepted = events.subspan(first, last - first);
+            for (const auto& event : accepted) {
+                if (!(levels & utils::levelBit(event.level))) {
+                    filtered.clear();
+                    for (const auto& kept : accepted) {
+                        if (levels & utils::levelBit(kept.level)) filtered.push_back(kept);
+                    }
+                    accepted = filtered;
+                    break;
+                }
             }
         }
+
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            subscription.sink->writeBatch(accepted);
+        } catch (...) {
+            subscription.counters->errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        subscription.counters->writeTime.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        subscription.counters->events.fetch_add(accepted.size(), std::memory_order_relaxed);
+    }
+    filtered.clear();
+}
+
+void LogEventRouter::flush() noexcept {
+    const auto routes = snapshot.load(std::memory_order_acquire);
+    std::lock_guard lock(writeMutex);
+    for (const auto& subscription : routes->subscriptions) {
+        try {
+            subscription.sink->flush();
+        } catch (...) {
+            subscription.counters->errors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void LogEventRouter::writeTo(LogSink& sink, const utils::LogEvent& event) {
+    std::lock_guard lock(writeMutex);
+    sink.write(event);
+}
+
+std::vector<SinkMetrics> LogEventRouter::sinkMetrics() const {
+    const auto routes = snapshot.load(std::memory_order_acquire);
+    std::vector<SinkMetrics> result;
+    result.reserve(routes->subscriptions.size());
+    for (const auto& subscription : routes->subscriptions) {
+        SinkMetrics& metrics = result.emplace_back();
+        metrics.sink = subscription.sink;
+        metrics.levels = subscription.levels;
+        metrics.events = subscription.counters->events.load(std::memory_order_relaxed);
+        metrics.errors = subscription.counters->errors.load(std::memory_order_relaxed);
+        subscription.counters->writeTime.addTo(metrics.writeTime);
     }
-}
\ No newline at end of file
+    return result;
+}
@@ -0,0 +1,118 @@
+#include "loggerCpp/logger.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+    // Serializes creation and level changes; isEnabled() does not take it
+    std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    // Every logger by name, the root included; entries are never removed
+    std::map<std::string, std::unique_ptr<Logger>, std::less<>>& registry() {
+        static std::map<std::string, std::unique_ptr<Logger>, std::less<>> loggers;
+        return loggers;
+    }
+
+    // Lowest effective level of any logger: the router must not drop what one of them lets through
+    utils::LogLevel lowestLevelLocked() noexcept {
+        utils::LogLevel lowest = utils::LogLevel::NONE;
+        for (const auto& [name, logger] : registry()) {
+            lowest = std::min(lowest, logger->level());
+        }
+        return lowest;
+    }
+}
+
+Logger::Logger(std::string name, Logger* parent) noexcept
+    : effectiveLevel(parent ? parent->level() : LoggingEngine::globalLogLevel.load(std::memory_order_relaxed)),
+      fullName(std::move(name)), parentLogger(parent) {
+    if (!parent) ownLevel = effectiveLevel.load(std::memory_order_relaxed);
+}
+
+Logger& Logger::root() noexcept {
+    static Logger& instance = [&]() -> Logger& {
+        std::lock_guard lock(registryMutex());
+        auto& slot = registry()[std::string()];
+        slot.reset(new Logger(std::string(), nullptr));
+        return *slot;
+    }();
+    return instance;
+}
+
+Logger& Logger::get(std::string_view name) {
+    if (name.empty()) return root();
+    if (name.front() == '.' || name.back() == '.' || name.find("..") != std::string_view::npos) {
+        throw std::invalid_argument("invalid logger name \"" + std::string(name) + "\"");
+    }
+
+    Logger* parent = &root();
+    std::lock_guard lock(registryMutex());
+    auto& loggers = registry();
+    if (const auto found = loggers.find(name); found != loggers.end()) return *found->second;
+
+    // Create the missing ancestors from the top: "net", then "net.http"
+    std::size_t end = 0;
+    do {
+        end = name.find('.', end + 1);
+        const std::string_view prefix = name.substr(0, end);
+        auto found = loggers.find(prefix);
+        if (found == loggers.end()) {
+            std::unique_ptr<Logger> created(new Logger(std::string(prefix), parent));
+            parent->children.push_back(created.get());
+            found = loggers.emplace(std::string(prefix), std::move(created)).first;
+        }
+        parent = found->second.get();
+    } while (end != std::string_view::npos);
+    return *parent;
+}
+
+std::optional<utils::LogLevel> Logger::assignedLevel() const {
+    std::lock_guard lock(registryMutex());
+    return ownLevel;
+}
+
+void Logger::setLevel(utils::LogLevel level) {
+    if (!parentLogger) {
+        LoggingEngine::getInstance().setLogLevel(level);
+        return;
+    }
+    std::lock_guard lock(registryMutex());
+    assignLocked(level);
+}
+
+void Logger::resetLevel() {
+    if (!parentLogger) return;
+    std::lock_guard lock(registryMutex());
+    assignLocked(std::nullopt);
+}
+
+void Logger::setRootLevel(utils::LogLevel level) noexcept {
+    Logger& rootLogger = root();
+    std::lock_guard lock(registryMutex());
+    rootLogger.assignLocked(level);
+}
+
+void Logger::assignLocked(std::optional<utils::LogLevel> level) noexcept {
+    ownLevel = level;
+
+    // Depth-first over the subtree; a logger with its own level keeps it and shields its children
+    std::vector<Logger*> pending{this};
+    while (!pending.empty()) {
+        Logger* logger = pending.back();
+        pending.pop_back();
+        const utils::LogLevel effective = logger->ownLevel ? *logger->ownLevel : logger->parentLogger->level();
+        logger->effectiveLevel.store(effective, std::memory_order_relaxed);
+        for (Logger* child : logger->children) {
+            if (!child->ownLevel) pending.push_back(child);
+        }
+    }
+
+    LoggingEngine::getInstance().router.setLogLevel(lowestLevelLocked());
+}
@@ -1,6 +1,8 @@
 // LoggingEngine.cpp
 
 #include "loggerCpp/loggingEngine.hpp"
+#include "loggerCpp/logger.hpp"
+#include <algorithm>
 #include <memory>
 #include <latch>
 #include <semaphore>
@@ -11,8 +13,9 @@ LoggingEngine& LoggingEngine::getInstance() noexcept {
     return instance;
 }
 
-LoggingEngine::LoggingEngine() : globalLogLevel(utils::LogLevel::INFO), asyncMode(false), stopLogging(false) 
+LoggingEngine::LoggingEngine() : asyncMode(false), stopLogging(false) 
 {
+    batch.reserve(BATCH_SIZE);
     startAsync();
 }
 
@@ -21,34 +24,307 @@ LoggingEngine::~LoggingEngine() noexcept {
 }
 
 void LoggingEngine::setLogLevel(utils::LogLevel level) noexcept {
-    std::lock_guard lock(sinkMutex);
-    globalLogLevel = level;
-    router.setLogLevel(level);
+    globalLogLevel.store(level, std::memory_order_relaxed);
+    // The root logger propagates it and lowers the router's floor to the lowest logger level
+    Logger::setRootLevel(level);
+}
+
+void LoggingEngine::setFormatMode(utils::FormatMode mode) noexcept {
+    formatMode = mode;
+}
+
+void LoggingEngine::setQueuePolicy(const QueuePolicy& policy) noexcept {
+    queueCapacity.store(std::clamp<std::size_t>(policy.capacity, 1, QUEUE_CAPACITY), std::memory_order_relaxed);
+    queueMaxBytes.store(policy.maxBytes, std::memory_order_relaxed);
+    dropBelow.store(policy.dropBelow, std::memory_order_relaxed);
+    sampleRate.store(std::max<uint32_t>(policy.sampleRate, 1), std::memory_order_relaxed);
+    reportIntervalMs.store(policy.reportInterval.count(), std::memory_order_relaxed);
+    overflowPolicy.store(policy.overflow, std::memory_order_relaxed);
+}
+
+uint64_t LoggingEngine::droppedEvents(utils::LogLevel level) const noexcept {
+    if (level >= utils::LogLevel::NONE) return 0;
+    return droppedByLevel[static_cast<std::size_t>(level)].load(std::memory_order_relaxed);
+}
+
+EngineMetrics LoggingEngine::metrics() const {
+    EngineMetrics result;
+    for (const auto& shard : metricShards) {
+        for (std::size_t level = 0; level < utils::LEVEL_COUNT; ++level) {
+            result.enqueued[level] += shard.enqueued[level].load(std::memory_order_relaxed);
+            result.routed[level] += shard.routed[level].load(std::memory_order_relaxed);
+        }
+        shard.enqueueLatency.addTo(result.enqueueLatency);
+    }
+    for (std::size_t level = 0; level < utils::LEVEL_COUNT; ++level) {
+        result.dropped[level] = droppedByLevel[level].load(std::memory_order_relaxed);
+    }
+    result.queueDepth = eventQueue.size();
+    result.queueHighWater = queueHighWater.load(std::memory_order_relaxed);
+    result.sinks = router.sinkMetrics();
+    return result;
+}
+
+void LoggingEngine::setMetricsSink(std::shared_ptr<LogSink> sink, std::chrono::milliseconds interval) {
+    metricsIntervalMs.store(interval.count(), std::memory_order_relaxed);
+    metricsSink.store(std::move(sink), std::memory_order_release);
+}
+
+std::string EngineMetrics::toString() const {
+    const auto sum = [](const auto& perLevel) {
+        uint64_t total = 0;
+        for (const uint64_t count : perLevel) total += count;
+        return total;
+    };
+
+    fmt::memory_buffer out;
+    fmt::format_to(fmt::appender(out),
+        "engine metrics: enqueued {} routed {} dropped {} queue {} (high {}) enqueue p50 {}ns p99 {}ns p999 {}ns max {}ns",
+        sum(enqueued), sum(routed), sum(dropped), queueDepth, queueHighWater,
+        enqueueLatency.percentile(0.50), enqueueLatency.percentile(0.99),
+        enqueueLatency.percentile(0.999), enqueueLatency.maxNs);
+    for (std::size_t index = 0; index < sinks.size(); ++index) {
+        const SinkMetrics& sink = sinks[index];
+        fmt::format_to(fmt::appender(out), "; sink {} events {} errors {} write p50 {}ns p99 {}ns max {}ns",
+            index, sink.events, sink.errors, sink.writeTime.percentile(0.50), sink.writeTime.percentile(0.99),
+            sink.writeTime.maxNs);
+    }
+    return fmt::to_string(out);
+}
+
+LoggingEngine::MetricShard& LoggingEngine::localShard() noexcept {
+    static std::atomic<std::size_t> nextShard{0};
+    static thread_local const std::size_t index = nextShard.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+    return metricShards[index];
 }
 
 void LoggingEngine::addSink(std::shared_ptr<LogSink> sink, utils::LogLevel level) {
-    std::lock_guard lock(sinkMutex);
-    sinks.emplace_back(std::move(sink), level);
-    router.addRoute(level, sinks.back().first);
+    router.addRoute(utils::levelsFrom(level), std::move(sink));
+}
+
+void LoggingEngine::addSink(std::shared_ptr<LogSink> sink, utils::LevelMask levels) {
+    router.addRoute(levels, std::move(sink));
+}
+
+void LoggingEngine::setSinks(std::vector<SinkRoute> routes) {
+    router.replaceRoutes(std::move(routes));
+}
+
+void LoggingEngine::clearSinks() {
+    router.clearRoutes();
 }
 
 void LoggingEngine::processEvent(const utils::LogEvent& event) noexcept {
-    if (event.level < globalLogLevel) [[unlikely]] return;
+    if (!isEnabled(event.level)) [[unlikely]] return;
+
+    processEvent(utils::LogEvent(event));
+}
 
+void LoggingEngine::processEvent(utils::LogEvent&& event) noexcept {
+    if (!isEnabled(event.level)) [[unlikely]] return;
+
+    dispatch(std::move(event));
+}
+
+void LoggingEngine::dispatch(utils::LogEvent&& event) noexcept {
+    if (event.level >= utils::LogLevel::NONE) [[unlikely]] return;
+
+    const auto level = static_cast<std::size_t>(event.level);
     if (asyncMode) {
-        std::lock_guard lock(queueMutex);
-        eventQueue.push(event);
-        queueCV.notify_one();
+        if (!admit(event)) [[unlikely]] return;
+        const uint64_t created = event.timestamp;
+        // Admission keeps the queue within the ring size; only a lowered capacity can leave it full
+        while (!eventQueue.tryPush(std::move(event))) [[unlikely]] {
+            wakeConsumer();
+            std::this_thread::yield();
+        }
+        wakeConsumer();
+
+        const auto now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        MetricShard& shard = localShard();
+        shard.enqueued[level].fetch_add(1, std::memory_order_relaxed);
+        shard.enqueueLatency.record(now > created ? now - created : 0);
+
+        // stopAsync() may have made its last drain between the check above and the push; pairs
+        // with the fence there, so either it sees the event or this thread sees async mode off
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!asyncMode.load(std::memory_order_relaxed)) [[unlikely]] {
+            std::lock_guard lock(lifecycleMutex);
+            // Re-checked under the lock: no logging thread runs while it is off
+            if (!asyncMode.load(std::memory_order_relaxed)) {
+                while (drainBatch() != 0) {}
+            }
+        }
     } else {
+        if (event.isDeferred()) [[unlikely]] {
+            // Async mode was switched off after the event was captured
+            utils::renderDeferred(event, callerScratch());
+        }
         router.routeEvent(event);
+        localShard().routed[level].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool LoggingEngine::admit(const utils::LogEvent& event) noexcept {
+    const std::size_t bytes = event.footprint();
+    if (tryReserve(bytes)) [[likely]] return true;
+
+    switch (overflowPolicy.load(std::memory_order_relaxed)) {
+        case utils::OverflowPolicy::DROP_NEWEST:
+            countDrop(event.level);
+            return false;
+        case utils::OverflowPolicy::DROP_OLDEST:
+            while (!tryReserve(bytes)) {
+                if (auto oldest = eventQueue.tryPop()) {
+                    release(oldest->footprint());
+                    countDrop(oldest->level);
+                } else {
+                    // Everything admitted is still being pushed or was just taken by the logging thread
+                    std::this_thread::yield();
+                }
+            }
+            return true;
+        case utils::OverflowPolicy::DROP_BELOW_LEVEL:
+            if (event.level < dropBelow.load(std::memory_order_relaxed)) {
+                countDrop(event.level);
+                return false;
+            }
+            break;
+        case utils::OverflowPolicy::SAMPLE:
+            if (overflowCount.fetch_add(1, std::memory_order_relaxed) % sampleRate.load(std::memory_order_relaxed) != 0) {
+                countDrop(event.level);
+                return false;
+            }
+            break;
+        case utils::OverflowPolicy::BLOCK:
+            break;
+    }
+
+    // Back off until the logging thread makes room
+    while (!tryReserve(bytes)) {
+        wakeConsumer();
+        std::this_thread::yield();
     }
+    return true;
+}
+
+bool LoggingEngine::tryReserve(std::size_t bytes) noexcept {
+    const std::size_t events = queuedEvents.fetch_add(1, std::memory_order_relaxed) + 1;
+    const std::size_t total = queuedBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    const std::size_t maxBytes = queueMaxBytes.load(std::memory_order_relaxed);
+    // An event larger than the whole byte budget is still let through into an empty queue
+    if (events <= queueCapacity.load(std::memory_order_relaxed) &&
+        (maxBytes == 0 || total <= maxBytes || events == 1)) [[likely]] {
+        std::size_t highWater = queueHighWater.load(std::memory_order_relaxed);
+        while (events > highWater && !queueHighWater.compare_exchange_weak(highWater, events, std::memory_order_relaxed)) {}
+        return true;
+    }
+    release(bytes);
+    return false;
+}
+
+void LoggingEngine::release(std::size_t bytes) noexcept {
+    queuedEvents.fetch_sub(1, std::memory_order_relaxed);
+    queuedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void LoggingEngine::countDrop(utils::LogLevel level) noexcept {
+    droppedByLevel[static_cast<std::size_t>(level)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LoggingEngine::reportDrops(bool force) noexcept {
+    std::array<uint64_t, utils::LEVEL_COUNT> dropped{};
+    uint64_t total = 0;
+    for (std::size_t level = 0; level < utils::LEVEL_COUNT; ++level) {
+        dropped[level] = droppedByLevel[level].load(std::memory_order_relaxed) - reportedDrops[level];
+        total += dropped[level];
+    }
+    if (total == 0) [[likely]] return;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!force && now - lastDropReport < std::chrono::milliseconds(reportIntervalMs.load(std::memory_order_relaxed))) {
+        return;
+    }
+    lastDropReport = now;
+
+    fmt::memory_buffer message;
+    fmt::format_to(fmt::appender(message), "{} events dropped by the queue overflow policy (", total);
+    const char* separator = "";
+    for (std::size_t level = 0; level < utils::LEVEL_COUNT; ++level) {
+        if (dropped[level] != 0) {
+            fmt::format_to(fmt::appender(message), "{}{} {}", separator,
+                utils::getLogLevelString(static_cast<utils::LogLevel>(level)), dropped[level]);
+            separator = ", ";
+        }
+        reportedDrops[level] += dropped[level];
+    }
+    message.push_back(')');
+
+    static const utils::CallSite site{utils::LogLevel::WARNING, std::source_location::current(), {}};
+    router.routeEvent(utils::LogEvent(site, std::string_view(message.data(), message.size())));
+}
+
+void LoggingEngine::reportMetrics() noexcept {
+    const auto sink = metricsSink.load(std::memory_order_acquire);
+    if (!sink) [[likely]] return;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastMetricsReport < std::chrono::milliseconds(metricsIntervalMs.load(std::memory_order_relaxed))) {
+        return;
+    }
+    lastMetricsReport = now;
+
+    try {
+        const std::string report = metrics().toString();
+        static const utils::CallSite site{utils::LogLevel::INFO, std::source_location::current(), {}};
+        router.writeTo(*sink, utils::LogEvent(site, report));
+    } catch (...) {
+        // A failing metrics sink must not take the logging thread down
+    }
+}
+
+void LoggingEngine::wakeConsumer() noexcept {
+    // Pairs with the fence in processEventQueue: either we see the consumer parked,
+    // or the consumer sees our event before parking
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumerSleeping.load(std::memory_order_relaxed) && consumerSleeping.exchange(false)) {
+        queueSem.release();
+    }
+}
+
+std::size_t LoggingEngine::drainBatch() noexcept {
+    batch.clear();
+    while (batch.size() < BATCH_SIZE) {
+        auto event = eventQueue.tryPop();
+        if (!event) break;
+        release(event->footprint());
+        if (event->isDeferred()) {
+            utils::renderDeferred(*event, formatScratch);
+        }
+        batch.push_back(std::move(*event));
+    }
+
+    if (!batch.empty()) {
+        router.routeBatch(batch);
+
+        std::array<uint64_t, utils::LEVEL_COUNT> routed{};
+        for (const auto& event : batch) {
+            ++routed[static_cast<std::size_t>(event.level)];
+        }
+        MetricShard& shard = localShard();
+        for (std::size_t level = 0; level < utils::LEVEL_COUNT; ++level) {
+            if (routed[level] != 0) shard.routed[level].fetch_add(routed[level], std::memory_order_relaxed);
+        }
+    }
+    return batch.size();
 }
 
 void LoggingEngine::startAsync() noexcept {
-    std::lock_guard lock(queueMutex);
+    std::lock_guard lock(lifecycleMutex);
     if (!asyncMode) {
-        asyncMode = true;
         stopLogging = false;
+        asyncMode = true;
         loggingThread = std::jthread([this](std::stop_token stoken) {
             processEventQueue();
         });
@@ -56,32 +332,49 @@ void LoggingEngine::startAsync() noexcept {
 }
 
 void LoggingEngine::stopAsync() noexcept {
-    {
-        std::lock_guard lock(queueMutex);
-        if (!asyncMode) return;
-        stopLogging = true;
-        queueCV.notify_one();
-    }
+    std::lock_guard lock(lifecycleMutex);
+    if (!asyncMode) return;
+    // Turn async mode off before waiting: the logging thread runs until it sees the queue empty,
+    // which producers that keep logging in async mode could put off indefinitely
+    asyncMode = false;
+    stopLogging = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wakeConsumer();
     if (loggingThread.joinable()) {
         loggingThread.join();
     }
-    asyncMode = false;
+
+    // Producers that raced with shutdown may still have pushed after the final drain; any that
+    // push after this one drain the queue themselves (see dispatch())
+    while (drainBatch() != 0) {}
+    reportDrops(true);
+    router.flush();
 }
 
 void LoggingEngine::processEventQueue() noexcept {
     while (true) {
-        std::unique_lock lock(queueMutex);
-        queueCV.wait(lock, [this]() { return !eventQueue.empty() || stopLogging; });
+        while (drainBatch() != 0) {}
+        reportDrops();
+        reportMetrics();
 
-        if (stopLogging && eventQueue.empty()) [[unlikely]] break;
+        if (stopLogging) [[unlikely]] {
+            if (eventQueue.empty()) break;
+            continue;
+        }
 
-        while (!eventQueue.empty()) {
-            auto event = std::move(eventQueue.front());
-            eventQueue.pop();
+        // Park until a producer wakes us; re-check the queue after announcing it
+        consumerSleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!eventQueue.empty() || stopLogging) {
+            if (!consumerSleeping.exchange(false)) queueSem.acquire();
+            continue;
+        }
 
-            lock.unlock();
-            router.routeEvent(event);
-            lock.lock();
+        if (!queueSem.try_acquire_for(IDLE_TIMEOUT)) {
+            // Timed out, but a producer may have claimed the wakeup in the meantime
+            if (!consumerSleeping.exchange(false)) queueSem.acquire();
+            // Queue has been idle for a while: push out whatever the sinks are buffering
+            router.flush();
         }
     }
 }
\ No newline at end of file
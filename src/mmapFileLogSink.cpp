@@ -0,0 +1,265 @@
+#include "loggerCpp/mmapFileLogSink.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    constexpr std::size_t HEADER_SIZE = 64; // Records start on their own cache line
+    static_assert(sizeof(MmapSegmentHeader) <= HEADER_SIZE);
+
+    // Longest the writer waits for a segment still being preallocated before dropping the record
+    constexpr std::chrono::milliseconds PREPARE_WAIT{100};
+    // Shortest time between two attempts to create a segment after a failure
+    constexpr std::chrono::seconds RETRY_INTERVAL{1};
+}
+
+MmapFileLogSink::MmapFileLogSink(std::string_view basePath, const MmapSegmentPolicy& policy)
+    : basePath(basePath), policy(policy) {
+    if (this->policy.segmentSize <= HEADER_SIZE) {
+        throw std::runtime_error("Segment size too small for mmap log sink");
+    }
+
+    // Continue after segments left by a previous run, which retention may have thinned from the front
+    const auto existing = existingSegments();
+    const uint64_t sequence = existing.empty() ? 1 : existing.back() + 1;
+
+    current = createSegment(sequence);
+    if (!current) {
+        throw std::runtime_error(fmt::format("Failed to create log segment: {}", segmentPath(sequence)));
+    }
+    writeOffset = HEADER_SIZE;
+
+    nextSequence = sequence + 1;
+    prepareNext = preparing = true;
+    segmentThread = std::jthread([this](std::stop_token stop) { segmentLoop(stop); });
+}
+
+MmapFileLogSink::~MmapFileLogSink() noexcept {
+    if (segmentThread.joinable()) {
+        segmentThread.request_stop();
+        segmentThread.join();
+    }
+    for (auto& segment : retiredSegments) {
+        retireSegment(std::move(segment));
+    }
+    if (current) {
+        retireSegment(std::move(current));
+    }
+    if (Segment* next = nextSegment.exchange(nullptr)) {
+        // Pre-created but never written: remove it entirely
+        munmap(next->base, next->capacity);
+        close(next->fd);
+        std::error_code ec;
+        std::filesystem::remove(segmentPath(next->sequence), ec);
+        delete next;
+    }
+}
+
+void MmapFileLogSink::write(const utils::LogEvent& event) {
+    writeBatch({&event, 1});
+}
+
+void MmapFileLogSink::writeBatch(std::span<const utils::LogEvent> events) {
+    for (const auto& event : events) {
+        record.clear();
+        fmt::format_to(fmt::appender(record), "[{}] {}\n[{}] {}\n",
+            utils::getLogLevelString(event.level),
+            locations.get(event.site, [](const utils::CallSite& site, std::string& text) {
+                text = fmt::format("({}:{})", site.function, site.line);
+            }),
+            timestampFormatter.format(event.timestamp),
+            event.message());
+        append({record.data(), record.size()});
+    }
+}
+
+void MmapFileLogSink::append(std::string_view text) {
+    if (writeOffset + text.size() > current->capacity) [[unlikely]] {
+        if (!switchSegment()) {
+            // No segment to switch to yet: keep the full one and count the record as lost
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // A record larger than a whole segment is cut to fit
+        text = text.substr(0, std::min<std::size_t>(text.size(), current->capacity - writeOffset));
+    }
+
+    std::memcpy(current->base + writeOffset, text.data(), text.size());
+    writeOffset += text.size();
+    current->header().committed.store(writeOffset, std::memory_order_release);
+}
+
+bool MmapFileLogSink::switchSegment() {
+    std::unique_ptr<Segment> next(nextSegment.exchange(nullptr, std::memory_order_acquire));
+    std::unique_lock lock(segmentMutex);
+    if (!next) [[unlikely]] {
+        // The background thread is still preallocating: only happens if a whole segment was
+        // filled faster than one could be created. Wait once per full segment, not per record.
+        if (!segmentFull) segmentCV.wait_for(lock, PREPARE_WAIT, [this] { return !preparing; });
+        next.reset(nextSegment.exchange(nullptr, std::memory_order_acquire));
+        if (!next) {
+            segmentFull = true;
+            // Creation failed (or is stuck): ask for another attempt, at most once per interval
+            const auto now = std::chrono::steady_clock::now();
+            if (preparing || now < nextRetry) return false;
+            nextRetry = now + RETRY_INTERVAL;
+            prepareNext = preparing = true;
+            segmentCV.notify_all();
+            segmentCV.wait_for(lock, PREPARE_WAIT, [this] { return !preparing; });
+            next.reset(nextSegment.exchange(nullptr, std::memory_order_acquire));
+            if (!next) return false;
+        }
+    }
+
+    retiredSegments.push_back(std::move(current));
+    nextSequence = next->sequence + 1;
+    prepareNext = preparing = true;
+    lock.unlock();
+    segmentCV.notify_all();
+
+    current = std::move(next);
+    writeOffset = HEADER_SIZE;
+    segmentFull = false;
+    return true;
+}
+
+uint64_t MmapFileLogSink::droppedRecords() const noexcept {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+std::unique_ptr<MmapFileLogSink::Segment> MmapFileLogSink::createSegment(uint64_t sequence) const {
+    const std::string path = segmentPath(sequence);
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Failed to create log segment " << path << ": " << std::strerror(errno) << '\n';
+        return nullptr;
+    }
+
+    if (const int err = posix_fallocate(fd, 0, static_cast<off_t>(policy.segmentSize)); err != 0) {
+        std::cerr << "Error: Failed to preallocate log segment " << path << ": " << std::strerror(err) << '\n';
+        ::close(fd);
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, policy.segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Error: Failed to map log segment " << path << ": " << std::strerror(errno) << '\n';
+        ::close(fd);
+        return nullptr;
+    }
+
+    auto segment = std::make_unique<Segment>();
+    segment->fd = fd;
+    segment->base = static_cast<char*>(base);
+    segment->capacity = policy.segmentSize;
+    segment->sequence = sequence;
+
+    auto* header = new (segment->base) MmapSegmentHeader{};
+    std::memcpy(header->magic, MmapSegmentHeader::MAGIC, sizeof(header->magic));
+    header->version = MmapSegmentHeader::VERSION;
+    header->headerSize = HEADER_SIZE;
+    header->capacity = policy.segmentSize;
+    header->sequence = sequence;
+    header->committed.store(HEADER_SIZE, std::memory_order_release);
+    return segment;
+}
+
+void MmapFileLogSink::retireSegment(std::unique_ptr<Segment> segment) const {
+    const uint64_t committed = segment->header().committed.load(std::memory_order_acquire);
+    munmap(segment->base, segment->capacity);
+    // Give back the unused preallocated tail; the header still records where data ends
+    if (ftruncate(segment->fd, static_cast<off_t>(committed)) != 0) {
+        std::cerr << "Error: Failed to trim log segment " << segmentPath(segment->sequence) << '\n';
+    }
+    ::close(segment->fd);
+
+    // Keep the newest maxSegments completed segments. Everything older goes, including segments left
+    // by an earlier run or kept under a larger maxSegments.
+    if (policy.maxSegments != 0 && segment->sequence > policy.maxSegments) {
+        const uint64_t oldestKept = segment->sequence - policy.maxSegments + 1;
+        std::error_code ec;
+        for (const uint64_t sequence : existingSegments()) {
+            if (sequence >= oldestKept) break;
+            std::filesystem::remove(segmentPath(sequence), ec);
+        }
+    }
+}
+
+void MmapFileLogSink::segmentLoop(std::stop_token stop) {
+    std::unique_lock lock(segmentMutex);
+    while (segmentCV.wait(lock, stop, [this] { return prepareNext || !retiredSegments.empty(); })) {
+        auto retired = std::move(retiredSegments);
+        retiredSegments.clear();
+        const bool prepare = std::exchange(prepareNext, false);
+        const uint64_t sequence = nextSequence;
+        lock.unlock();
+
+        if (prepare) {
+            auto next = createSegment(sequence);
+            lock.lock();
+            nextSegment.store(next.release(), std::memory_order_release);
+            preparing = false;
+            lock.unlock();
+            segmentCV.notify_all();
+        }
+        for (auto& segment : retired) {
+            retireSegment(std::move(segment));
+        }
+
+        lock.lock();
+    }
+}
+
+std::string MmapFileLogSink::segmentPath(uint64_t sequence) const {
+    return fmt::format("{}.{:06}.log", basePath, sequence);
+}
+
+std::vector<uint64_t> MmapFileLogSink::existingSegments() const {
+    namespace fs = std::filesystem;
+    const fs::path base(basePath);
+    const std::string prefix = base.filename().string() + '.';
+    constexpr std::string_view SUFFIX = ".log";
+
+    std::vector<uint64_t> sequences;
+    std::error_code ec;
+    for (fs::directory_iterator it(base.has_parent_path() ? base.parent_path() : fs::path("."), ec), end;
+         !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() <= prefix.size() + SUFFIX.size() || !name.starts_with(prefix) || !name.ends_with(SUFFIX)) {
+            continue;
+        }
+        const std::string_view digits = std::string_view(name).substr(prefix.size(), name.size() - prefix.size() - SUFFIX.size());
+        uint64_t sequence = 0;
+        const auto [parsed, error] = std::from_chars(digits.data(), digits.data() + digits.size(), sequence);
+        if (error == std::errc{} && parsed == digits.data() + digits.size() && sequence != 0) {
+            sequences.push_back(sequence);
+        }
+    }
+    std::ranges::sort(sequences);
+    return sequences;
+}
+
+std::string MmapFileLogSink::readSegment(std::string_view segmentPath) {
+    std::ifstream file(std::string(segmentPath), std::ios::binary);
+    MmapSegmentHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, MmapSegmentHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(fmt::format("Not a log segment: {}", segmentPath));
+    }
+
+    const uint64_t committed = header.committed.load();
+    std::string text(committed > header.headerSize ? committed - header.headerSize : 0, '\0');
+    file.seekg(header.headerSize);
+    file.read(text.data(), static_cast<std::streamsize>(text.size()));
+    text.resize(static_cast<std::size_t>(file.gcount()));
+    return text;
+}
@@ -1,15 +1,431 @@
 #include "loggerCpp/networkLogSink.hpp"
+#include "loggerCpp/jsonEscape.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <ctime>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+    constexpr int CONNECT_TIMEOUT_MS = 2000;            // Longest wait for a TCP handshake
+    constexpr int POLL_INTERVAL_MS = 100;               // Longest wait for a full socket before re-checking for shutdown
+    constexpr std::size_t DATAGRAMS_PER_CALL = 64;      // Records per sendmmsg() call
+
+    int severityOf(utils::LogLevel level) noexcept {
+        switch (level) {
+            case utils::LogLevel::CRITICAL: return 2;
+            case utils::LogLevel::ERROR: return 3;
+            case utils::LogLevel::WARNING: return 4;
+            case utils::LogLevel::INFO: return 6;
+            default: return 7;
+        }
+    }
+
+    // RFC 5424 header fields are printable US-ASCII without spaces, "-" when empty
+    std::string sanitiseField(std::string_view value, std::size_t maxLength) {
+        std::string result;
+        for (const char c : value.substr(0, maxLength)) {
+            result.push_back(c > ' ' && c < 0x7f ? c : '_');
+        }
+        return result.empty() ? std::string("-") : result;
+    }
+
+    std::invalid_argument badUrl(std::string_view url, std::string_view reason) {
+        return std::invalid_argument(fmt::format("NetworkLogSink: {} in URL '{}'", reason, url));
+    }
+}
+
+NetworkLogSink::NetworkLogSink(std::string_view url, const NetworkSinkOptions& options)
+    : protocol(Protocol::TCP), options(options), processId(static_cast<int>(::getpid())) {
+    const std::size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string_view::npos) throw badUrl(url, "missing scheme");
+    const std::string_view scheme = url.substr(0, schemeEnd);
+    if (scheme == "tcp") {
+        protocol = Protocol::TCP;
+    } else if (scheme == "udp") {
+        protocol = Protocol::UDP;
+    } else {
+        throw badUrl(url, "unsupported scheme, expected tcp or udp");
+    }
+
+    std::string_view authority = url.substr(schemeEnd + 3);
+    authority = authority.substr(0, authority.find('/'));
+    std::string_view portText;
+    if (authority.starts_with('[')) {
+        const std::size_t close = authority.find(']');
+        if (close == std::string_view::npos) throw badUrl(url, "unterminated IPv6 address");
+        host = authority.substr(1, close - 1);
+        const std::string_view rest = authority.substr(close + 1);
+        if (!rest.empty()) {
+            if (rest.front() != ':') throw badUrl(url, "unexpected text after IPv6 address");
+            portText = rest.substr(1);
+        }
+    } else {
+        const std::size_t colon = authority.rfind(':');
+        host = authority.substr(0, colon);
+        if (colon != std::string_view::npos) portText = authority.substr(colon + 1);
+    }
+    if (host.empty()) throw badUrl(url, "missing host");
+
+    if (portText.empty()) {
+        port = "514";
+    } else {
+        unsigned value = 0;
+        const auto [end, error] = std::from_chars(portText.data(), portText.data() + portText.size(), value);
+        if (error != std::errc{} || end != portText.data() + portText.size() || value == 0 || value > 65535) {
+            throw badUrl(url, "invalid port");
+        }
+        port = portText;
+    }
+
+    char name[256]{};
+    hostname = sanitiseField(::gethostname(name, sizeof(name) - 1) == 0 ? name : "", 255);
+    appName = sanitiseField(options.appName, 48);
+    this->options.reconnectMin = std::max(options.reconnectMin, std::chrono::milliseconds(1));
+    this->options.reconnectMax = std::max(options.reconnectMax, this->options.reconnectMin);
+    backoff = this->options.reconnectMin;
+    nextConnect = std::chrono::steady_clock::now();
+
+    sender = std::thread([this] { senderLoop(); });
+}
+
+NetworkLogSink::~NetworkLogSink() noexcept {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (sender.joinable()) {
+        sender.join();
+    }
+}
 
 void NetworkLogSink::write(const utils::LogEvent& event) {
-    // TODO: Implement network logging
-    // This would send logs to a remote logging service
-    std::cerr << "Error: Network logging not implemented\n";
-    throw std::runtime_error("Network logging not implemented");
-}
-
-NetworkLogSink::NetworkLogSink(const std::string_view& url) {
-    // TODO: Implement network logging
-    // This would send logs to a remote logging service
-    std::cerr << "Error: Network logging not implemented\n";
-    throw std::runtime_error("Network logging not implemented");
-}
\ No newline at end of file
+    writeBatch({&event, 1});
+}
+
+void NetworkLogSink::writeBatch(std::span<const utils::LogEvent> events) {
+    staging.clear();
+    stagingSizes.clear();
+    for (const auto& event : events) {
+        const std::size_t start = staging.size();
+        formatRecord(event);
+        if (protocol == Protocol::TCP && options.format == NetworkFormat::SYSLOG) {
+            // RFC 6587 octet counting: "MSG-LEN SP SYSLOG-MSG"
+            const fmt::format_int length(record.size());
+            staging.append(length.data(), length.data() + length.size());
+            staging.push_back(' ');
+        }
+        staging.append(record.data(), record.data() + record.size());
+        stagingSizes.push_back(static_cast<uint32_t>(staging.size() - start));
+    }
+
+    bool notify = false;
+    {
+        std::lock_guard lock(mutex);
+        const bool wasEmpty = pending.empty();
+        std::size_t offset = 0;
+        for (const uint32_t size : stagingSizes) {
+            if (pendingBytes.load(std::memory_order_relaxed) + size > options.maxPendingBytes) {
+                // Collector slow or away for long enough to fill the budget
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                pending.append(staging.data() + offset, size);
+                pendingSizes.push_back(size);
+                pendingBytes.fetch_add(size, std::memory_order_relaxed);
+            }
+            offset += size;
+        }
+        if (wasEmpty && !pending.empty()) {
+            firstPending = std::chrono::steady_clock::now();
+            notify = true;
+        }
+        notify = notify || pending.size() >= options.batchBytes;
+    }
+    if (notify) {
+        wake.notify_one();
+    }
+}
+
+void NetworkLogSink::flush() {
+    {
+        std::lock_guard lock(mutex);
+        if (pending.empty()) return;
+        flushRequested = true;
+    }
+    wake.notify_one();
+}
+
+NetworkSinkStats NetworkLogSink::stats() const noexcept {
+    NetworkSinkStats result;
+    result.sent = sent.load(std::memory_order_relaxed);
+    result.dropped = dropped.load(std::memory_order_relaxed);
+    result.connects = connects.load(std::memory_order_relaxed);
+    result.pendingBytes = pendingBytes.load(std::memory_order_relaxed);
+    result.connected = connected.load(std::memory_order_relaxed);
+    return result;
+}
+
+void NetworkLogSink::formatRecord(const utils::LogEvent& event) {
+    record.clear();
+    const std::string_view time = formatTimestamp(event.timestamp);
+
+    if (options.format == NetworkFormat::SYSLOG) {
+        // No STRUCTURED-DATA and no MSGID
+        fmt::format_to(fmt::appender(record), "<{}>1 {} {} {} {} - - {}",
+            options.facility * 8 + severityOf(event.level), time, hostname, appName, processId, event.message());
+        return;
+    }
+
+    fmt::format_to(fmt::appender(record), R"({{"timestamp":"{}","host":")", time);
+    utils::appendJsonEscaped(record, hostname);
+    record.append(std::string_view(R"(","app":")"));
+    utils::appendJsonEscaped(record, appName);
+    fmt::format_to(fmt::appender(record), R"(","pid":{},"level":"{}","file":")", processId, utils::getLogLevelString(event.level));
+    // File, line and function are escaped once per call site
+    record.append(locations.get(event.site, [](const utils::CallSite& site, std::string& text) {
+        fmt::memory_buffer out;
+        utils::appendJsonEscaped(out, site.file);
+        fmt::format_to(fmt::appender(out), R"(","line":{},"function":")", site.line);
+        utils::appendJsonEscaped(out, site.function);
+        text = fmt::to_string(out);
+    }));
+    record.append(std::string_view(R"(","message":")"));
+    utils::appendJsonEscaped(record, event.message());
+    record.append(std::string_view("\"}\n"));
+}
+
+std::string_view NetworkLogSink::formatTimestamp(uint64_t timestamp) noexcept {
+    const auto seconds = static_cast<int64_t>(timestamp / 1'000'000'000);
+    if (seconds != cachedSecond) {
+        const auto time = static_cast<std::time_t>(seconds);
+        std::tm parts{};
+        ::gmtime_r(&time, &parts);
+        std::strftime(timestampText, sizeof(timestampText), "%Y-%m-%dT%H:%M:%S", &parts);
+        cachedSecond = seconds;
+    }
+    // The prefix is always 19 characters; append ".uuuuuuZ"
+    const auto micros = static_cast<unsigned>(timestamp % 1'000'000'000 / 1000);
+    fmt::format_to(timestampText + 19, ".{:06}Z", micros);
+    return {timestampText, 27};
+}
+
+void NetworkLogSink::senderLoop() noexcept {
+    std::unique_lock lock(mutex);
+    while (takePending(lock)) {
+        const bool closing = stopping;
+        if (closing && closeDeadline == std::chrono::steady_clock::time_point::max()) {
+            closeDeadline = std::chrono::steady_clock::now() + options.closeTimeout;
+        }
+        lock.unlock();
+
+        if (closing && std::chrono::steady_clock::now() >= closeDeadline) {
+            // Out of time: whatever is left is lost
+            completeRecords(sendingSizes.size() - sendingRecord, false);
+            lock.lock();
+            dropped.fetch_add(pendingSizes.size(), std::memory_order_relaxed);
+            pendingBytes.fetch_sub(pending.size(), std::memory_order_relaxed);
+            pending.clear();
+            pendingSizes.clear();
+            break;
+        }
+
+        if (socketFd < 0 && (std::chrono::steady_clock::now() < nextConnect || !connect())) {
+            // Back off; new records do not cut the wait short, shutdown does
+            lock.lock();
+            const auto until = closing ? std::min(nextConnect, closeDeadline) : nextConnect;
+            wake.wait_until(lock, until, [&] { return stopping != closing; });
+            continue;
+        }
+
+        transmit();
+        lock.lock();
+    }
+    lock.unlock();
+
+    if (socketFd >= 0) {
+        ::close(socketFd);
+        socketFd = -1;
+    }
+    connected.store(false, std::memory_order_relaxed);
+}
+
+bool NetworkLogSink::takePending(std::unique_lock<std::mutex>& lock) noexcept {
+    // Finish what was taken last time before taking more, so records stay in order
+    if (sendingRecord < sendingSizes.size()) return true;
+
+    wake.wait(lock, [&] { return !pending.empty() || stopping; });
+    if (pending.empty()) return false;
+
+    if (!stopping && !flushRequested && pending.size() < options.batchBytes) {
+        // Give more records a chance to share this send
+        wake.wait_until(lock, firstPending + options.linger,
+                        [&] { return stopping || flushRequested || pending.size() >= options.batchBytes; });
+    }
+
+    flushRequested = false;
+    sending.swap(pending);
+    sendingSizes.swap(pendingSizes);
+    pending.clear();
+    pendingSizes.clear();
+    sendingRecord = 0;
+    sendingCompleted = 0;
+    sendingOffset = 0;
+    return true;
+}
+
+bool NetworkLogSink::connect() noexcept {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = protocol == Protocol::TCP ? SOCK_STREAM : SOCK_DGRAM;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        disconnect();
+        return false;
+    }
+
+    for (const addrinfo* address = addresses; address != nullptr && socketFd < 0; address = address->ai_next) {
+        const int fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) continue;
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+        int result = ::connect(fd, address->ai_addr, address->ai_addrlen);
+        if (result != 0 && errno == EINPROGRESS) {
+            pollfd poll{fd, POLLOUT, 0};
+            int error = ETIMEDOUT;
+            socklen_t length = sizeof(error);
+            if (::poll(&poll, 1, CONNECT_TIMEOUT_MS) == 1) {
+                ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            }
+            result = error == 0 ? 0 : -1;
+        }
+        if (result == 0) {
+            socketFd = fd;
+        } else {
+            ::close(fd);
+        }
+    }
+    ::freeaddrinfo(addresses);
+
+    if (socketFd < 0) {
+        disconnect();
+        return false;
+    }
+    if (protocol == Protocol::TCP) {
+        // Batching is done here, Nagle would only add delay on top of linger
+        const int on = 1;
+        ::setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    backoff = options.reconnectMin;
+    connects.fetch_add(1, std::memory_order_relaxed);
+    connected.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void NetworkLogSink::disconnect() noexcept {
+    if (socketFd >= 0) {
+        ::close(socketFd);
+        socketFd = -1;
+    }
+    connected.store(false, std::memory_order_relaxed);
+    nextConnect = std::chrono::steady_clock::now() + backoff;
+    backoff = std::min(backoff * 2, options.reconnectMax);
+}
+
+bool NetworkLogSink::transmit() noexcept {
+    const bool ok = protocol == Protocol::TCP ? transmitStream() : transmitDatagrams();
+    if (!ok) {
+        disconnect();
+    }
+    return ok;
+}
+
+bool NetworkLogSink::transmitStream() noexcept {
+    while (sendingOffset < sending.size()) {
+        const ssize_t written = ::send(socketFd, sending.data() + sendingOffset, sending.size() - sendingOffset, MSG_NOSIGNAL);
+        if (written > 0) {
+            sendingOffset += static_cast<std::size_t>(written);
+            std::size_t records = 0;
+            std::size_t end = sendingCompleted;
+            while (sendingRecord + records < sendingSizes.size() && end + sendingSizes[sendingRecord + records] <= sendingOffset) {
+                end += sendingSizes[sendingRecord + records];
+                ++records;
+            }
+            completeRecords(records, true);
+            continue;
+        }
+        if (written < 0 && errno == EINTR) continue;
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd poll{socketFd, POLLOUT, 0};
+            ::poll(&poll, 1, POLL_INTERVAL_MS);
+            return true;
+        }
+
+        // Connection lost; a partly sent record cannot be resumed on a new connection
+        if (sendingOffset > sendingCompleted) {
+            completeRecords(1, false);
+            sendingOffset = sendingCompleted;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool NetworkLogSink::transmitDatagrams() noexcept {
+    while (sendingRecord < sendingSizes.size()) {
+#ifdef __linux__
+        std::array<mmsghdr, DATAGRAMS_PER_CALL> messages{};
+        std::array<iovec, DATAGRAMS_PER_CALL> vectors{};
+        const std::size_t count = std::min(DATAGRAMS_PER_CALL, sendingSizes.size() - sendingRecord);
+        std::size_t offset = sendingCompleted;
+        for (std::size_t i = 0; i < count; ++i) {
+            vectors[i] = {sending.data() + offset, sendingSizes[sendingRecord + i]};
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            offset += sendingSizes[sendingRecord + i];
+        }
+        const int datagrams = ::sendmmsg(socketFd, messages.data(), static_cast<unsigned>(count), MSG_NOSIGNAL);
+#else
+        const ssize_t written = ::send(socketFd, sending.data() + sendingCompleted, sendingSizes[sendingRecord], MSG_NOSIGNAL);
+        const int datagrams = written < 0 ? -1 : 1;
+#endif
+        if (datagrams > 0) {
+            completeRecords(static_cast<std::size_t>(datagrams), true);
+            continue;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            pollfd poll{socketFd, POLLOUT, 0};
+            ::poll(&poll, 1, POLL_INTERVAL_MS);
+            return true;
+        }
+        if (errno == EBADF || errno == ENOTSOCK) return false;
+
+        // Datagrams are independent: drop the one that failed (too large, refused by the peer) and go on
+        completeRecords(1, false);
+    }
+    return true;
+}
+
+void NetworkLogSink::completeRecords(std::size_t records, bool delivered) noexcept {
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < records; ++i) {
+        bytes += sendingSizes[sendingRecord + i];
+    }
+    sendingRecord += records;
+    sendingCompleted += bytes;
+    pendingBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    (delivered ? sent : dropped).fetch_add(records, std::memory_order_relaxed);
+}
@@ -1,26 +1,61 @@
 #include "loggerCpp/sysLogSink.hpp"
-#include <format>
+#include <fmt/format.h>
 
-SysLogSink::SysLogSink(std::string_view ident, int facility) {
-    // Open syslog connection with specified identity and facility
-    openlog(ident.data(), LOG_PID | LOG_NDELAY, facility);
+#include <functional>
+#include <mutex>
+#include <set>
+
+namespace {
+    // openlog() and closelog() act on one process-wide connection: the newest sink's ident
+    // applies, and only the last sink to go closes it, so a replacing sink survives the old one
+    std::mutex& connectionMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::size_t openSinks = 0;
+
+    // openlog() keeps the pointer, which must stay valid after the sink that passed it is gone
+    const char* internIdent(std::string_view ident) {
+        static std::set<std::string, std::less<>> idents;
+        auto found = idents.find(ident);
+        if (found == idents.end()) found = idents.emplace(ident).first;
+        return found->c_str();
+    }
+}
+
+SysLogSink::SysLogSink(std::string_view ident, int facility) : facility(facility) {
+    std::lock_guard lock(connectionMutex());
+    openlog(internIdent(ident), LOG_PID | LOG_NDELAY, facility);
+    ++openSinks;
 }
 
 SysLogSink::~SysLogSink() noexcept {
-    // Close syslog connection
-    closelog();
+    std::lock_guard lock(connectionMutex());
+    if (--openSinks == 0) {
+        closelog();
+    }
 }
 
 void SysLogSink::write(const utils::LogEvent& event) {
-    // Format message with timestamp and location info
-    std::string formatted_message = std::format("{} (function: {} line: {})",
-        event.message, 
-        event.location.function_name(),
-        event.location.line()
-    );
-
-    // Write to syslog with appropriate priority level
-    syslog(logLevelToSyslogPriority(event.level), "%s", formatted_message.c_str());
+    writeBatch({&event, 1});
+}
+
+void SysLogSink::writeBatch(std::span<const utils::LogEvent> events) {
+    // syslog() takes one message per call; the batch saves the per-event dispatch and the text
+    // is built in a reused buffer, the location rendered once per call site
+    for (const auto& event : events) {
+        buffer.clear();
+        buffer.append(event.message());
+        buffer.append(locations.get(event.site, [](const utils::CallSite& site, std::string& text) {
+            text = fmt::format(" (function: {} line: {})", site.function, site.line);
+        }));
+        buffer.push_back('\0');
+
+        // Syslog stamps its own time. The facility is given per message as another sink may
+        // have opened the connection with its own
+        syslog(facility | logLevelToSyslogPriority(event.level), "%s", buffer.data());
+    }
 }
 
 int SysLogSink::logLevelToSyslogPriority(utils::LogLevel level) noexcept {
@@ -0,0 +1,87 @@
+#include "loggerCpp/timestampFormatter.hpp"
+
+#include <ctime>
+#include <cstring>
+
+namespace {
+    // Writes value as exactly `digits` decimal digits, zero padded
+    char* writeDigits(char* out, uint32_t value, int digits) noexcept {
+        for (int i = digits - 1; i >= 0; --i) {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        return out + digits;
+    }
+
+    // Local broken-down time plus offset from UTC in seconds
+    long localTime(std::time_t seconds, std::tm& local) noexcept {
+#ifdef _WIN32
+        localtime_s(&local, &seconds);
+        std::tm utc{};
+        gmtime_s(&utc, &seconds);
+        utc.tm_isdst = local.tm_isdst;
+        return static_cast<long>(std::difftime(std::mktime(&local), std::mktime(&utc)));
+#else
+        localtime_r(&seconds, &local);
+        return local.tm_gmtoff;
+#endif
+    }
+}
+
+utils::TimestampFormatter::TimestampFormatter(Precision precision, bool showOffset) noexcept
+    : precision(precision), showOffset(showOffset) {}
+
+void utils::TimestampFormatter::refresh(int64_t seconds) noexcept {
+    std::tm local{};
+    const long gmtOffset = localTime(static_cast<std::time_t>(seconds), local);
+
+    char* out = buffer;
+    out = writeDigits(out, static_cast<uint32_t>(local.tm_year + 1900), 4);
+    *out++ = '-';
+    out = writeDigits(out, static_cast<uint32_t>(local.tm_mon + 1), 2);
+    *out++ = '-';
+    out = writeDigits(out, static_cast<uint32_t>(local.tm_mday), 2);
+    *out++ = ' ';
+    out = writeDigits(out, static_cast<uint32_t>(local.tm_hour), 2);
+    *out++ = ':';
+    out = writeDigits(out, static_cast<uint32_t>(local.tm_min), 2);
+    *out++ = ':';
+    out = writeDigits(out, static_cast<uint32_t>(local.tm_sec), 2);
+    prefixLength = static_cast<std::size_t>(out - buffer);
+
+    const long absOffset = gmtOffset < 0 ? -gmtOffset : gmtOffset;
+    offset[0] = ' ';
+    offset[1] = gmtOffset < 0 ? '-' : '+';
+    writeDigits(offset + 2, static_cast<uint32_t>(absOffset / 3600), 2);
+    writeDigits(offset + 4, static_cast<uint32_t>(absOffset % 3600 / 60), 2);
+
+    cachedSecond = seconds;
+}
+
+std::string_view utils::TimestampFormatter::format(uint64_t timestamp) noexcept {
+    const auto seconds = static_cast<int64_t>(timestamp / 1'000'000'000);
+    const auto nanos = static_cast<uint32_t>(timestamp % 1'000'000'000);
+
+    if (seconds != cachedSecond) [[unlikely]] {
+        refresh(seconds);
+    }
+
+    char* out = buffer + prefixLength;
+    switch (precision) {
+        case Precision::MILLISECONDS:
+            *out++ = '.';
+            out = writeDigits(out, nanos / 1'000'000, 3);
+            break;
+        case Precision::MICROSECONDS:
+            *out++ = '.';
+            out = writeDigits(out, nanos / 1'000, 6);
+            break;
+        default:
+            break;
+    }
+    if (showOffset) {
+        std::memcpy(out, offset, 6);
+        out += 6;
+    }
+    return {buffer, static_cast<std::size_t>(out - buffer)};
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal assertion for the test programs: prints the failed condition and exits non-zero
+#define CHECK(condition, ...)                                                                   \
+    do {                                                                                        \
+        if (!(condition)) {                                                                     \
+            fmt::print(stderr, "{}:{}: CHECK({}) failed. ", __FILE__, __LINE__, #condition);    \
+            fmt::print(stderr, "" __VA_ARGS__);                                                 \
+            std::fputc('\n', stderr);                                                           \
+            std::exit(1);                                                                       \
+        }                                                                                       \
+    } while (false)
+
+// Exit code telling CTest the test could not run in this build, see SKIP_RETURN_CODE
+inline constexpr int TEST_SKIPPED = 77;
@@ -0,0 +1,72 @@
+// A reload that changes a file sink's options creates a new sink on the same path. The old one
+// must be closed before the new one opens the file: both rotating it used to leave the new
+// sink writing whole segments into an unlinked name.next.
+
+#include "check.hpp"
+#include "loggerCpp/configurationManager.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+    constexpr int EVENTS = 2000;
+
+    void writeConfig(const std::filesystem::path& config, const std::filesystem::path& log, std::size_t maxBytes) {
+        std::ofstream(config) << fmt::format(
+            R"({{"level": "INFO", "async": false, "sinks": [{{"type": "file", "path": "{}", "rotation": {{"maxBytes": {}, "maxFiles": 1000}}}}]}})",
+            log.generic_string(), maxBytes);
+    }
+}
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / fmt::format("loggerCpp_configReloadTest_{}", ::getpid());
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const auto config = dir / "config.json";
+    const auto log = dir / "app.log";
+
+    {
+        ConfigurationManager manager;
+        writeConfig(config, log, 8192);
+        try {
+            manager.loadConfigFile(config);
+        } catch (const std::runtime_error& e) {
+            if (std::string_view(e.what()).find("without nlohmann/json") != std::string_view::npos) return TEST_SKIPPED;
+            throw;
+        }
+
+        int next = 0;
+        for (; next < EVENTS / 4; ++next) LOG_INFO("event-{}", next);
+        // Same path, other rotation size: a new sink
+        writeConfig(config, log, 4096);
+        manager.loadConfigFile(config);
+        for (; next < EVENTS; ++next) LOG_INFO("event-{}", next);
+        LoggingEngine::getInstance().clearSinks();
+    }
+
+    // Every event is in exactly one of the segments left on disk
+    std::vector<int> seen(EVENTS, 0);
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (!entry.path().filename().string().starts_with("app.log")) continue;
+        std::ifstream file(entry.path());
+        std::string line;
+        while (std::getline(file, line)) {
+            const std::size_t at = line.find("] event-");
+            if (at == std::string::npos) continue;
+            const int id = std::stoi(line.substr(at + 8));
+            CHECK(id >= 0 && id < EVENTS, "unexpected event {}", id);
+            ++seen[id];
+        }
+    }
+    for (int id = 0; id < EVENTS; ++id) {
+        CHECK(seen[id] == 1, "event-{} written {} times", id, seen[id]);
+    }
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,64 @@
+// FileLogReader finds records by their "[LEVEL] (function:line)" header line. A message with a
+// newline followed by text shaped like such a header must stay part of its record, with or
+// without an index, instead of showing up as an extra record of its own.
+
+#include "check.hpp"
+#include "loggerCpp/fileLogIndex.hpp"
+#include "loggerCpp/fileLogSink.hpp"
+
+#include <filesystem>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+namespace {
+    constexpr int EVENTS = 300;
+    constexpr std::string_view FORGED = "[CRITICAL] (forged:1)\n[2001-01-01 00:00:00.000] forged record";
+
+    void query(std::string_view path, std::string_view what) {
+        FileLogReader reader(path);
+        int all = 0;
+        int multiLine = 0;
+        reader.query({}, [&](const FileLogReader::Record& record) {
+            ++all;
+            CHECK(record.level != utils::LogLevel::CRITICAL, "{}: forged record: {}", what, record.text);
+            if (record.text.find("forged record") != std::string_view::npos) {
+                CHECK(record.level == utils::LogLevel::WARNING && record.text.ends_with("forged record\n"),
+                      "{}: record {}", what, record.text);
+                ++multiLine;
+            }
+        });
+        CHECK(all == EVENTS, "{}: {} records read, {} written", what, all, EVENTS);
+        CHECK(multiLine == EVENTS / 3, "{}: {} multi-line records", what, multiLine);
+
+        int critical = 0;
+        reader.query({.levels = utils::levelBit(utils::LogLevel::CRITICAL)}, [&](const FileLogReader::Record&) { ++critical; });
+        CHECK(critical == 0, "{}: {} CRITICAL records", what, critical);
+    }
+}
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / fmt::format("loggerCpp_fileLogIndexTest_{}", ::getpid());
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::string indexed = (dir / "indexed.log").string();
+    const std::string plain = (dir / "plain.log").string();
+
+    {
+        FileLogSink indexedSink(indexed, {}, {}, {.blockBytes = 1024});
+        FileLogSink plainSink(plain);
+        for (int i = 0; i < EVENTS; ++i) {
+            const std::string message = i % 3 == 0 ? fmt::format("event-{}\n{}", i, FORGED) : fmt::format("event-{}", i);
+            const utils::LogEvent event(i % 3 == 0 ? utils::LogLevel::WARNING : utils::LogLevel::INFO, message,
+                                        std::source_location::current());
+            indexedSink.write(event);
+            plainSink.write(event);
+        }
+    }
+
+    query(indexed, "indexed");
+    query(plain, "plain");
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,32 @@
+// A FileLogSink whose writes fail (here ENOSPC from /dev/full) must report every failed write
+// instead of leaving the stream failed and silently dropping everything after the first one.
+
+#include "check.hpp"
+#include "loggerCpp/fileLogSink.hpp"
+
+#include <filesystem>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+
+int main() {
+    if (!std::filesystem::exists("/dev/full")) return TEST_SKIPPED;
+
+    FileLogSink sink("/dev/full");
+    const utils::LogEvent event(utils::LogLevel::INFO, "lost", std::source_location::current());
+
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        sink.writeBatch({&event, 1});
+        bool thrown = false;
+        try {
+            sink.flush();
+        } catch (const std::runtime_error& e) {
+            thrown = true;
+            CHECK(std::string(e.what()).find("/dev/full") != std::string::npos, "message: {}", e.what());
+        }
+        CHECK(thrown, "write {} to /dev/full was not reported", attempt);
+        // Reported once: nothing is pending after the failure
+        sink.flush();
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+// MmapFileLogSink retention keeps the newest maxSegments completed segments. Segments left by an
+// earlier run without a limit are expired too, not only the one maxSegments behind each closed
+// segment, and a run started after retention thinned the front continues the numbering.
+
+#include "check.hpp"
+#include "loggerCpp/mmapFileLogSink.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <source_location>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+    constexpr std::size_t SEGMENT_SIZE = 4096;
+
+    void writeEvents(MmapFileLogSink& sink, int count) {
+        for (int i = 0; i < count; ++i) {
+            const std::string message = fmt::format("event-{} with some padding to fill segments", i);
+            sink.write(utils::LogEvent(utils::LogLevel::INFO, message, std::source_location::current()));
+        }
+    }
+
+    // Numbers of the app.NNNNNN.log files in dir, ascending
+    std::vector<uint64_t> segments(const std::filesystem::path& dir) {
+        std::vector<uint64_t> sequences;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            const std::string name = entry.path().filename().string();
+            if (name.starts_with("app.") && name.ends_with(".log")) {
+                sequences.push_back(std::stoull(name.substr(4, name.size() - 8)));
+            }
+        }
+        std::ranges::sort(sequences);
+        return sequences;
+    }
+
+    bool contiguous(const std::vector<uint64_t>& sequences) {
+        return std::ranges::adjacent_find(sequences, [](uint64_t a, uint64_t b) { return b != a + 1; }) == sequences.end();
+    }
+}
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path() / fmt::format("loggerCpp_mmapRetentionTest_{}", ::getpid());
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::string base = (dir / "app").string();
+
+    {
+        MmapFileLogSink sink(base, {.segmentSize = SEGMENT_SIZE, .maxSegments = 0});
+        writeEvents(sink, 1000);
+    }
+    const auto unlimited = segments(dir);
+    CHECK(unlimited.size() > 10 && unlimited.front() == 1 && contiguous(unlimited), "{} segments", unlimited.size());
+
+    {
+        MmapFileLogSink sink(base, {.segmentSize = SEGMENT_SIZE, .maxSegments = 3});
+        writeEvents(sink, 200);
+    }
+    const auto limited = segments(dir);
+    CHECK(limited.size() == 3 && contiguous(limited), "{} segments left, first {}", limited.size(), limited.front());
+    CHECK(limited.front() > unlimited.back(), "second run reused segment {}", limited.front());
+
+    // Restarting after the front was expired: continue after the newest segment, not at 1
+    {
+        MmapFileLogSink sink(base, {.segmentSize = SEGMENT_SIZE, .maxSegments = 3});
+        writeEvents(sink, 1);
+    }
+    const auto restarted = segments(dir);
+    CHECK(restarted.size() == 3 && contiguous(restarted) && restarted.back() == limited.back() + 1,
+          "segments {}..{} after restart", restarted.front(), restarted.back());
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,230 @@
+// NetworkLogSink against listeners on 127.0.0.1: RFC 5424 records with RFC 6587 octet counting
+// over TCP, JSON lines over UDP (one datagram each, batched through sendmmsg()), and a
+// reconnect to a listener that only starts after records were queued.
+
+#include "check.hpp"
+#include "loggerCpp/networkLogSink.hpp"
+
+#include <chrono>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef __unix__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    constexpr std::chrono::seconds TIMEOUT{5};
+
+    // Socket bound to 127.0.0.1, on the given port or a free one; listening if it is a stream
+    class Listener {
+    public:
+        Listener(int type, uint16_t port = 0) {
+            fd = ::socket(AF_INET, type | SOCK_CLOEXEC, 0);
+            CHECK(fd >= 0);
+            const int one = 1;
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(port);
+            socklen_t length = sizeof(address);
+            CHECK(::bind(fd, reinterpret_cast<sockaddr*>(&address), length) == 0, "bind to port {}", port);
+            CHECK(::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0);
+            boundPort = ntohs(address.sin_port);
+            if (type == SOCK_STREAM) CHECK(::listen(fd, 4) == 0);
+        }
+
+        ~Listener() {
+            if (peer >= 0) ::close(peer);
+            ::close(fd);
+        }
+
+        Listener(const Listener&) = delete;
+        Listener& operator=(const Listener&) = delete;
+
+        [[nodiscard]] uint16_t port() const noexcept { return boundPort; }
+
+        // Reads the accepted connection until it holds at least `bytes`, or TIMEOUT passes
+        std::string readStream(std::size_t bytes) {
+            std::string data;
+            const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+            while (data.size() < bytes && std::chrono::steady_clock::now() < deadline) {
+                const int socket = peer >= 0 ? peer : fd;
+                pollfd ready{socket, POLLIN, 0};
+                if (::poll(&ready, 1, 50) <= 0) continue;
+                if (peer < 0) {
+                    peer = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+                    continue;
+                }
+                char chunk[4096];
+                const ssize_t got = ::recv(peer, chunk, sizeof(chunk), 0);
+                if (got <= 0) break;
+                data.append(chunk, static_cast<std::size_t>(got));
+            }
+            return data;
+        }
+
+        // Receives up to `count` datagrams, stopping early once TIMEOUT passes
+        std::vector<std::string> readDatagrams(std::size_t count) {
+            std::vector<std::string> datagrams;
+            const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+            while (datagrams.size() < count && std::chrono::steady_clock::now() < deadline) {
+                pollfd ready{fd, POLLIN, 0};
+                if (::poll(&ready, 1, 50) <= 0) continue;
+                char datagram[65536];
+                const ssize_t got = ::recv(fd, datagram, sizeof(datagram), 0);
+                if (got > 0) datagrams.emplace_back(datagram, static_cast<std::size_t>(got));
+            }
+            return datagrams;
+        }
+
+    private:
+        int fd{-1};
+        int peer{-1};
+        uint16_t boundPort{0};
+    };
+
+    utils::LogEvent event(utils::LogLevel level, std::string_view message,
+                          std::source_location location = std::source_location::current()) {
+        return utils::LogEvent(level, message, location);
+    }
+
+    // Counters are updated by the sender thread once send() returned, possibly after the peer saw the data
+    template<typename Predicate>
+    bool eventually(Predicate predicate) {
+        const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // Reads "MSG-LEN SP SYSLOG-MSG" frames from the listener's connection until `count` are complete
+    std::vector<std::string> readRecords(Listener& listener, std::size_t count) {
+        std::string stream;
+        std::vector<std::string> records;
+        const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+        while (records.size() < count && std::chrono::steady_clock::now() < deadline) {
+            stream += listener.readStream(1);
+            records.clear();
+            std::string_view rest = stream;
+            for (std::size_t space; (space = rest.find(' ')) != std::string_view::npos;) {
+                const std::string_view length = rest.substr(0, space);
+                CHECK(!length.empty() && length.find_first_not_of("0123456789") == std::string_view::npos,
+                      "no length prefix in \"{}\"", rest);
+                const std::size_t size = std::stoul(std::string(length));
+                if (rest.size() < space + 1 + size) break;
+                records.emplace_back(rest.substr(space + 1, size));
+                rest.remove_prefix(space + 1 + size);
+            }
+        }
+        return records;
+    }
+
+    void tcpSyslog() {
+        Listener listener(SOCK_STREAM);
+        NetworkSinkOptions options;
+        options.appName = "netTest";
+        options.linger = std::chrono::milliseconds(1);
+        NetworkLogSink sink(fmt::format("tcp://127.0.0.1:{}", listener.port()), options);
+
+        const std::vector<utils::LogEvent> events{event(utils::LogLevel::INFO, "first"),
+                                                  event(utils::LogLevel::ERROR, "second with spaces"),
+                                                  event(utils::LogLevel::WARNING, "third")};
+        sink.writeBatch(events);
+        sink.flush();
+
+        const auto records = readRecords(listener, events.size());
+        CHECK(records.size() == events.size(), "received {} of {} records", records.size(), events.size());
+
+        const std::string pid = std::to_string(::getpid());
+        const std::string_view priorities[] = {"<14>1 ", "<11>1 ", "<12>1 "};   // Facility 1 (user), severities 6, 3, 4
+        const std::string_view messages[] = {"first", "second with spaces", "third"};
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const std::string& record = records[i];
+            CHECK(record.starts_with(priorities[i]), "record {}: {}", i, record);
+            CHECK(record.find(" netTest " + pid + " - - ") != std::string::npos, "record {}: {}", i, record);
+            CHECK(record.ends_with(messages[i]), "record {}: {}", i, record);
+        }
+        CHECK(eventually([&] { return sink.stats().sent == events.size(); }), "sent {}", sink.stats().sent);
+    }
+
+    void udpJsonLines() {
+        Listener listener(SOCK_DGRAM);
+        NetworkSinkOptions options;
+        options.format = NetworkFormat::JSON_LINES;
+        options.appName = "netTest";
+        options.linger = std::chrono::milliseconds(1);
+        NetworkLogSink sink(fmt::format("udp://127.0.0.1:{}", listener.port()), options);
+
+        // More records than one sendmmsg() call takes
+        constexpr std::size_t COUNT = 150;
+        std::vector<utils::LogEvent> events;
+        for (std::size_t i = 0; i < COUNT; ++i) {
+            events.push_back(event(utils::LogLevel::WARNING, fmt::format("say \"hi\" #{}", i)));
+        }
+        sink.writeBatch(events);
+        sink.flush();
+
+        const auto datagrams = listener.readDatagrams(COUNT);
+        CHECK(datagrams.size() == COUNT, "received {} of {} datagrams", datagrams.size(), COUNT);
+        for (std::size_t i = 0; i < COUNT; ++i) {
+            const std::string& line = datagrams[i];
+            CHECK(line.starts_with(R"({"timestamp":")") && line.ends_with("\"}\n"), "datagram {}: {}", i, line);
+            CHECK(line.find(R"("app":"netTest")") != std::string::npos, "datagram {}: {}", i, line);
+            CHECK(line.find(R"("level":"WARNING")") != std::string::npos, "datagram {}: {}", i, line);
+            CHECK(line.find(fmt::format(R"("message":"say \"hi\" #{}")", i)) != std::string::npos, "datagram {}: {}", i, line);
+        }
+    }
+
+    void reconnectToLateListener() {
+        // Find a free port, then leave it closed until records are waiting
+        uint16_t port = 0;
+        {
+            Listener probe(SOCK_STREAM);
+            port = probe.port();
+        }
+
+        NetworkSinkOptions options;
+        options.linger = std::chrono::milliseconds(1);
+        options.reconnectMin = std::chrono::milliseconds(20);
+        options.reconnectMax = std::chrono::milliseconds(100);
+        NetworkLogSink sink(fmt::format("tcp://127.0.0.1:{}", port), options);
+
+        const auto early = event(utils::LogLevel::INFO, "queued while away");
+        sink.writeBatch({&early, 1});
+        sink.flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        CHECK(!sink.stats().connected);
+        CHECK(sink.stats().sent == 0);
+
+        Listener listener(SOCK_STREAM, port);
+        const auto records = readRecords(listener, 1);
+        CHECK(records.size() == 1 && records[0].ends_with("queued while away"), "received {} records", records.size());
+        CHECK(eventually([&] { return sink.stats().sent == 1; }), "sent {}", sink.stats().sent);
+        CHECK(sink.stats().connects == 1, "connects {}", sink.stats().connects);
+    }
+}
+
+int main() {
+    tcpSyslog();
+    udpJsonLines();
+    reconnectToLateListener();
+    return 0;
+}
+
+#else
+
+int main() {
+    return TEST_SKIPPED;
+}
+
+#endif
@@ -0,0 +1,85 @@
+#include "loggerCpp/binaryLogFormat.hpp"
+#include "loggerCpp/jsonEscape.hpp"
+#include "loggerCpp/timestampFormatter.hpp"
+
+#include <fmt/format.h>
+
+#include <cstdio>
+#include <exception>
+#include <string_view>
+
+namespace {
+    void printUsage() {
+        std::fputs("Usage: loggerCpp-decode [--json] FILE...\n"
+                   "Decodes files written by BinaryLogSink to text (default) or JSON lines.\n", stderr);
+    }
+
+    void appendText(fmt::memory_buffer& out, const BinaryLogReader::Event& event, utils::TimestampFormatter& timestamps) {
+        fmt::format_to(fmt::appender(out), "[{}] ({}:{})\n[{}] {}\n",
+            utils::getLogLevelString(event.level),
+            event.site->function,
+            event.site->line,
+            timestamps.format(event.timestamp),
+            event.message);
+    }
+
+    void appendJson(fmt::memory_buffer& out, const BinaryLogReader::Event& event) {
+        fmt::format_to(fmt::appender(out), R"({{"timestamp":{},"level":"{}","file":")",
+            event.timestamp, utils::getLogLevelString(event.level));
+        utils::appendJsonEscaped(out, event.site->file);
+        out.append(std::string_view(R"(","function":")"));
+        utils::appendJsonEscaped(out, event.site->function);
+        fmt::format_to(fmt::appender(out), R"(","line":{},"message":")", event.site->line);
+        utils::appendJsonEscaped(out, event.message);
+        out.append(std::string_view("\"}\n"));
+    }
+
+    int decode(std::string_view path, bool json) {
+        BinaryLogReader reader(path);
+        utils::TimestampFormatter timestamps;
+        fmt::memory_buffer out;
+        BinaryLogReader::Event event;
+
+        while (reader.next(event)) {
+            if (json) {
+                appendJson(out, event);
+            } else {
+                appendText(out, event, timestamps);
+            }
+            if (out.size() >= 64 * 1024) {
+                std::fwrite(out.data(), 1, out.size(), stdout);
+                out.clear();
+            }
+        }
+        std::fwrite(out.data(), 1, out.size(), stdout);
+
+        if (reader.truncated()) {
+            fmt::print(stderr, "Warning: {} ends with an incomplete record\n", path);
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool json = false;
+    int first = 1;
+    if (argc > 1 && std::string_view(argv[1]) == "--json") {
+        json = true;
+        first = 2;
+    }
+    if (first >= argc) {
+        printUsage();
+        return 2;
+    }
+
+    int status = 0;
+    for (int i = first; i < argc; ++i) {
+        try {
+            status |= decode(argv[i], json);
+        } catch (const std::exception& e) {
+            fmt::print(stderr, "Error: {}\n", e.what());
+            status = 1;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,125 @@
+#include "loggerCpp/fileLogIndex.hpp"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <string_view>
+
+namespace {
+    void printUsage() {
+        std::fputs("Usage: loggerCpp-query [--from TIME] [--to TIME] [--since DURATION] [--level L,L...]\n"
+                   "                       [--min-level L] [--stats] FILE...\n"
+                   "Prints the records of FileLogSink files in a time range and set of levels, using the\n"
+                   "file's .idx index to skip blocks that cannot match.\n"
+                   "  TIME      local time as written in the log, \"YYYY-MM-DD HH:MM:SS[.fff]\"\n"
+                   "  DURATION  a number followed by s, m, h or d, e.g. 15m\n", stderr);
+    }
+
+    bool parseDuration(std::string_view text, std::chrono::nanoseconds& duration) {
+        if (text.size() < 2) return false;
+        char* end = nullptr;
+        const long long count = std::strtoll(std::string(text.substr(0, text.size() - 1)).c_str(), &end, 10);
+        if (count <= 0 || *end != '\0') return false;
+        switch (text.back()) {
+            case 's': duration = std::chrono::seconds(count); return true;
+            case 'm': duration = std::chrono::minutes(count); return true;
+            case 'h': duration = std::chrono::hours(count); return true;
+            case 'd': duration = std::chrono::days(count); return true;
+            default: return false;
+        }
+    }
+
+    bool parseLevels(std::string_view text, utils::LevelMask& levels) {
+        levels = 0;
+        for (std::size_t pos = 0; pos <= text.size();) {
+            const std::size_t comma = std::min(text.find(',', pos), text.size());
+            const utils::LogLevel level = utils::stringToLogLevel(std::string(text.substr(pos, comma - pos)));
+            if (level == utils::LogLevel::NONE) return false;
+            levels |= utils::levelBit(level);
+            pos = comma + 1;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    FileLogReader::Query query;
+    bool showStats = false;
+    int first = 1;
+
+    for (; first < argc; ++first) {
+        const std::string_view arg = argv[first];
+        if (!arg.starts_with("--")) break;
+        if (arg == "--stats") {
+            showStats = true;
+            continue;
+        }
+        if (first + 1 >= argc) {
+            printUsage();
+            return 2;
+        }
+        const std::string_view value = argv[++first];
+        bool ok = true;
+        if (arg == "--from") {
+            ok = FileLogReader::parseTime(value, query.from);
+        } else if (arg == "--to") {
+            ok = FileLogReader::parseTime(value, query.to);
+        } else if (arg == "--since") {
+            std::chrono::nanoseconds duration{};
+            ok = parseDuration(value, duration);
+            const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch());
+            query.from = static_cast<uint64_t>((now - duration).count());
+        } else if (arg == "--level") {
+            ok = parseLevels(value, query.levels);
+        } else if (arg == "--min-level") {
+            const utils::LogLevel level = utils::stringToLogLevel(std::string(value));
+            ok = level != utils::LogLevel::NONE;
+            query.levels = utils::levelsFrom(level);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fmt::print(stderr, "Error: invalid {} '{}'\n", arg, value);
+            printUsage();
+            return 2;
+        }
+    }
+    if (first >= argc) {
+        printUsage();
+        return 2;
+    }
+
+    int status = 0;
+    fmt::memory_buffer out;
+    for (int i = first; i < argc; ++i) {
+        try {
+            const auto start = std::chrono::steady_clock::now();
+            FileLogReader reader(argv[i]);
+            const auto stats = reader.query(query, [&](const FileLogReader::Record& record) {
+                out.append(record.text);
+                if (out.size() >= 64 * 1024) {
+                    std::fwrite(out.data(), 1, out.size(), stdout);
+                    out.clear();
+                }
+            });
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+
+            if (showStats) {
+                const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                fmt::print(stderr, "{}: {} records, read {} of {} blocks ({} bytes){} in {:.1f} ms\n",
+                    argv[i], stats.matches, stats.blocksRead, stats.blocks, stats.bytesRead,
+                    reader.indexed() ? "" : ", no index", elapsed.count());
+            }
+        } catch (const std::exception& e) {
+            fmt::print(stderr, "Error: {}\n", e.what());
+            status = 1;
+        }
+    }
+    return status;
+}